@@ -5,13 +5,22 @@ in vec3 vWorldPos;
 
 uniform vec3 uColor;
 
+layout(std140) uniform SceneData {
+  mat4 uView;
+  mat4 uProj;
+  vec4 uLightDirAndAmbient;
+  vec4 uCameraPos;
+  vec4 uFogColor;
+  vec4 uFogParams;
+  vec4 uFogParams2;
+};
+
 out vec4 FragColor;
 
 void main() {
   vec3 normal = normalize(vNormal);
-  // Simple directional light (top-right-front)
-  vec3 lightDir = normalize(vec3(0.5, 1.0, 1.0));
-  float diff = max(dot(normal, lightDir), 0.2); // 0.2 min ambient
+  // Single directional light; w is the minimum (ambient) term
+  float diff = max(dot(normal, uLightDirAndAmbient.xyz), uLightDirAndAmbient.w);
   
   FragColor = vec4(uColor * diff, 1.0);
 }
@@ -3,8 +3,16 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 
-uniform mat4 uView;
-uniform mat4 uProjection;
+layout(std140) uniform SceneData {
+  mat4 uView;
+  mat4 uProj;
+  vec4 uLightDirAndAmbient;
+  vec4 uCameraPos;
+  vec4 uFogColor;
+  vec4 uFogParams;
+  vec4 uFogParams2;
+};
+
 uniform mat4 uModel;
 
 out vec3 vNormal;
@@ -14,5 +22,5 @@ void main() {
   vec4 worldPos = uModel * vec4(aPos, 1.0);
   vWorldPos = worldPos.xyz;
   vNormal = mat3(transpose(inverse(uModel))) * aNormal;
-  gl_Position = uProjection * uView * worldPos;
+  gl_Position = uProj * uView * worldPos;
 }
@@ -0,0 +1,39 @@
+#version 330 core
+// Bloom mip-chain downsample (dual filter): one bilinear tap at the centre
+// and four on the diagonals cover a 4x4 source footprint in five fetches.
+// The BLOOM_PREFILTER variant also applies the soft-knee brightness
+// threshold; it is used for the first step, from the layer to half size.
+in vec2 vTexCoord;
+out vec4 FragColor;
+
+uniform sampler2D uSource;
+uniform vec2 uSourceTexelSize;
+
+#ifdef BLOOM_PREFILTER
+uniform float uThreshold;
+uniform float uKnee; // Width of the soft transition below uThreshold
+
+vec3 Prefilter(vec3 color) {
+  float brightness = max(color.r, max(color.g, color.b));
+  float soft = clamp(brightness - uThreshold + uKnee, 0.0, 2.0 * uKnee);
+  soft = soft * soft / (4.0 * uKnee + 1e-4);
+  float contribution = max(soft, brightness - uThreshold);
+  return color * contribution / max(brightness, 1e-4);
+}
+#endif
+
+void main() {
+  vec2 d = uSourceTexelSize;
+  vec3 sum = texture(uSource, vTexCoord).rgb * 4.0;
+  sum += texture(uSource, vTexCoord + vec2(-d.x, -d.y)).rgb;
+  sum += texture(uSource, vTexCoord + vec2(d.x, -d.y)).rgb;
+  sum += texture(uSource, vTexCoord + vec2(-d.x, d.y)).rgb;
+  sum += texture(uSource, vTexCoord + vec2(d.x, d.y)).rgb;
+  vec3 color = sum * 0.125;
+
+#ifdef BLOOM_PREFILTER
+  color = Prefilter(color);
+#endif
+
+  FragColor = vec4(color, 1.0);
+}
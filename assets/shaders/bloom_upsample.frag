@@ -0,0 +1,42 @@
+#version 330 core
+// Bloom mip-chain upsample: 3x3 tent filter over the smaller level, added
+// onto the next larger level with GL_ONE/GL_ONE blending. uFilterRadius
+// scales the tap spacing (in source texels), which widens the bloom
+// without adding taps or levels.
+//
+// The BLOOM_APPLY variant is the last step, from the half-size level onto
+// the layer itself: it scales by uIntensity and writes an alpha so the glow
+// also shows where the layer was transparent.
+in vec2 vTexCoord;
+out vec4 FragColor;
+
+uniform sampler2D uSource;
+uniform vec2 uSourceTexelSize;
+uniform float uFilterRadius;
+
+#ifdef BLOOM_APPLY
+uniform float uIntensity;
+#endif
+
+void main() {
+  vec2 d = uSourceTexelSize * uFilterRadius;
+
+  vec3 sum = texture(uSource, vTexCoord).rgb * 4.0;
+  sum += texture(uSource, vTexCoord + vec2(-d.x, 0.0)).rgb * 2.0;
+  sum += texture(uSource, vTexCoord + vec2(d.x, 0.0)).rgb * 2.0;
+  sum += texture(uSource, vTexCoord + vec2(0.0, -d.y)).rgb * 2.0;
+  sum += texture(uSource, vTexCoord + vec2(0.0, d.y)).rgb * 2.0;
+  sum += texture(uSource, vTexCoord + vec2(-d.x, -d.y)).rgb;
+  sum += texture(uSource, vTexCoord + vec2(d.x, -d.y)).rgb;
+  sum += texture(uSource, vTexCoord + vec2(-d.x, d.y)).rgb;
+  sum += texture(uSource, vTexCoord + vec2(d.x, d.y)).rgb;
+  vec3 color = sum * (1.0 / 16.0);
+
+#ifdef BLOOM_APPLY
+  color *= uIntensity;
+  float alpha = clamp(max(color.r, max(color.g, color.b)), 0.0, 1.0);
+  FragColor = vec4(color, alpha);
+#else
+  FragColor = vec4(color, 1.0);
+#endif
+}
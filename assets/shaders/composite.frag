@@ -0,0 +1,59 @@
+#version 330 core
+// Fused layer composite: samples every visible layer once and reproduces the
+// fixed-function blend of LayerCompositor's multi-pass path, in render order,
+// writing straight to the default framebuffer.
+in vec2 TexCoords;
+out vec4 FragColor;
+
+// Must match LayerCompositor::kMaxFusedLayers.
+#define MAX_LAYERS 4
+
+// Matches the BlendMode enum order.
+#define BLEND_ADDITIVE 0
+#define BLEND_MULTIPLY 1
+#define BLEND_SCREEN 2
+#define BLEND_NORMAL 3
+
+uniform sampler2D uLayers[MAX_LAYERS];
+uniform int uBlendModes[MAX_LAYERS];
+uniform float uOpacities[MAX_LAYERS];
+// Per layer: offset (xy) and size (zw) of its rectangle in screen UV space.
+// Layer targets are only as large as that rectangle.
+uniform vec4 uLayerRects[MAX_LAYERS];
+uniform int uLayerCount;
+
+vec3 BlendLayer(vec3 dst, vec4 src, int mode) {
+    if (mode == BLEND_ADDITIVE) {
+        return src.rgb * src.a + dst;                 // SRC_ALPHA, ONE
+    } else if (mode == BLEND_MULTIPLY) {
+        return src.rgb * dst;                         // DST_COLOR, ZERO
+    } else if (mode == BLEND_SCREEN) {
+        return src.rgb + dst * (1.0 - src.rgb);       // ONE, ONE_MINUS_SRC_COLOR
+    }
+    return src.rgb * src.a + dst * (1.0 - src.a);     // SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+}
+
+// GLSL 3.30 only allows constant sampler array indices, so the layers are
+// unrolled by hand.
+// Pixels outside a layer's rectangle are left untouched by that layer, as
+// in the multi-pass path.
+#define COMPOSITE_LAYER(i)                                              \
+    if (i < uLayerCount) {                                              \
+        vec2 uv = (TexCoords - uLayerRects[i].xy) / uLayerRects[i].zw;  \
+        if (all(greaterThanEqual(uv, vec2(0.0))) &&                     \
+            all(lessThan(uv, vec2(1.0)))) {                             \
+            vec4 src = texture(uLayers[i], uv);                         \
+            src.a *= uOpacities[i];                                     \
+            color = BlendLayer(color, src, uBlendModes[i]);             \
+        }                                                               \
+    }
+
+void main() {
+    // The multi-pass path starts from a transparent black target.
+    vec3 color = vec3(0.0);
+    COMPOSITE_LAYER(0)
+    COMPOSITE_LAYER(1)
+    COMPOSITE_LAYER(2)
+    COMPOSITE_LAYER(3)
+    FragColor = vec4(color, 1.0);
+}
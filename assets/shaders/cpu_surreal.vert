@@ -1,20 +1,95 @@
 #version 330 core
 
+// GPU_DISPLACEMENT: the mesh is a static flat grid and the height field
+// (CPUVisualizer::UpdateMesh) is evaluated here instead, with the normal
+// taken from central differences one history row apart.
+
+#ifdef GPU_DISPLACEMENT
+layout(location = 0) in vec2 aGrid; // (x, z) in [0, 1]
+#else
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
+#endif
+
+layout(std140) uniform SceneData {
+  mat4 uView;
+  mat4 uProj;
+  vec4 uLightDirAndAmbient;
+  vec4 uCameraPos;
+  vec4 uFogColor;
+  vec4 uFogParams;
+  vec4 uFogParams2;
+};
 
-uniform mat4 uView;
-uniform mat4 uProjection;
 uniform mat4 uModel;
 
+#ifdef GPU_DISPLACEMENT
+uniform sampler2D uHistory;  // uHistoryLength x 1; r = usage, g = burst
+uniform float uHistoryLength;
+uniform float uHistoryHead;  // Texel of the newest row (ring write head)
+uniform float uSpectrum[10];
+uniform float uTime;
+uniform float uMacroPhase;
+uniform float uMesoPhase;
+uniform float uNormalStep; // One CPU grid step, so normals match that path
+
+float SampleSpectrum(float x01) {
+  float bandPos = x01 * 9.0;
+  int idx = clamp(int(bandPos), 0, 9);
+  float frac = bandPos - float(idx);
+  return mix(uSpectrum[idx], uSpectrum[min(idx + 1, 9)], frac);
+}
+
+// Row z of the history is texel (head + z) mod length; the texture repeats,
+// so linear filtering blends between rows across the wrap point too.
+vec2 SampleHistory(float z01) {
+  float u =
+      (uHistoryHead + z01 * (uHistoryLength - 1.0) + 0.5) / uHistoryLength;
+  return texture(uHistory, vec2(u, 0.5)).rg;
+}
+
+float Height(vec2 p) {
+  p = clamp(p, 0.0, 1.0);
+  vec2 c = (p - 0.5) * 2.0;
+  vec2 hist = SampleHistory(p.y);
+  float spectrumH = SampleSpectrum(p.x);
+
+  float macroWave = sin(c.x * 2.7 + c.y * 1.9 + uMacroPhase) * 0.20 +
+                    cos(c.y * 2.1 - uMacroPhase * 0.8) * 0.16;
+  float mesoWave = sin(c.x * 9.0 + uMesoPhase + spectrumH * 5.5) *
+                   (0.06 + 0.18 * spectrumH);
+  float fold = abs(sin(c.x * 4.2 + c.y * 3.0 + uTime * 0.85));
+  float silhouette = pow(clamp(hist.x, 0.0, 1.0), 1.25) * 1.55;
+
+  float y = silhouette;
+  y += macroWave * (0.45 + hist.x * 0.65);
+  y += mesoWave;
+  y += fold * (0.04 + hist.y * 0.22);
+
+  float depthMask = clamp(1.0 - p.y * 0.82, 0.12, 1.0);
+  float dreamBreath = 0.92 + 0.18 * sin(uTime * 0.35 + p.y * 5.2 + p.x * 1.8);
+  return y * depthMask * dreamBreath;
+}
+#endif
+
 out vec3 vNormal;
 out vec3 vWorldPos;
 out float vHeight;
 
 void main() {
+#ifdef GPU_DISPLACEMENT
+  float h = Height(aGrid);
+  float hL = Height(aGrid - vec2(uNormalStep, 0.0));
+  float hR = Height(aGrid + vec2(uNormalStep, 0.0));
+  float hD = Height(aGrid - vec2(0.0, uNormalStep));
+  float hU = Height(aGrid + vec2(0.0, uNormalStep));
+  vec3 aPos = vec3(aGrid.x, h, aGrid.y);
+  vec3 aNormal = normalize(vec3(hL - hR, 2.0, hD - hU));
+#endif
+
   vec4 worldPos = uModel * vec4(aPos, 1.0);
   vWorldPos = worldPos.xyz;
   vNormal = normalize(mat3(transpose(inverse(uModel))) * aNormal);
   vHeight = aPos.y;
-  gl_Position = uProjection * uView * worldPos;
+  gl_Position = uProj * uView * worldPos;
 }
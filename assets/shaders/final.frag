@@ -0,0 +1,131 @@
+#version 330 core
+// Final output stage, drawn by LayerCompositor::Present: reads the
+// composite once and writes the default framebuffer once. Every stage is a
+// permutation define, so disabled ones cost nothing:
+//   OUTPUT_FXAA     - FXAA 3.11-style edge blend; edges are detected on
+//                     tonemapped luma so they match what ends up on screen
+//   OUTPUT_BLOOM    - adds the half-size bloom level (BloomRenderer)
+//   OUTPUT_TONEMAP  - exposure and ACES filmic curve
+//   OUTPUT_VIGNETTE - darkens towards the corners
+//   OUTPUT_GRAIN    - animated film grain
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D screenTexture;
+uniform vec2 uTexelSize;
+
+#ifdef OUTPUT_BLOOM
+uniform sampler2D uBloomTexture;
+uniform vec2 uBloomTexelSize;
+uniform float uBloomStrength;
+#endif
+#ifdef OUTPUT_TONEMAP
+uniform float uExposure;
+#endif
+#ifdef OUTPUT_VIGNETTE
+uniform float uVignetteIntensity;
+uniform float uVignetteRadius;
+#endif
+#ifdef OUTPUT_GRAIN
+uniform float uGrainAmount;
+uniform float uTime;
+#endif
+
+float Luma(vec3 c) { return dot(c, vec3(0.2126, 0.7152, 0.0722)); }
+
+vec3 Tonemap(vec3 c) {
+#ifdef OUTPUT_TONEMAP
+  // Narkowicz's fit of the ACES reference curve
+  c *= uExposure;
+  c = (c * (2.51 * c + 0.03)) / (c * (2.43 * c + 0.59) + 0.14);
+#endif
+  return clamp(c, 0.0, 1.0);
+}
+
+#ifdef OUTPUT_FXAA
+vec3 Fxaa(vec2 uv) {
+  vec3 rgbM = texture(screenTexture, uv).rgb;
+  vec3 rgbNW = texture(screenTexture, uv + vec2(-uTexelSize.x, uTexelSize.y)).rgb;
+  vec3 rgbNE = texture(screenTexture, uv + uTexelSize).rgb;
+  vec3 rgbSW = texture(screenTexture, uv - uTexelSize).rgb;
+  vec3 rgbSE = texture(screenTexture, uv + vec2(uTexelSize.x, -uTexelSize.y)).rgb;
+
+  float lumaM = Luma(Tonemap(rgbM));
+  float lumaNW = Luma(Tonemap(rgbNW));
+  float lumaNE = Luma(Tonemap(rgbNE));
+  float lumaSW = Luma(Tonemap(rgbSW));
+  float lumaSE = Luma(Tonemap(rgbSE));
+
+  float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+  float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+  // Flat areas keep the centre sample and skip the four extra fetches.
+  if (lumaMax - lumaMin < max(0.0312, lumaMax * 0.125)) {
+    return rgbM;
+  }
+
+  vec2 dir;
+  dir.x = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+  dir.y = ((lumaNW + lumaSW) - (lumaNE + lumaSE));
+
+  float dirReduce =
+      max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * 0.125, 1.0 / 128.0);
+  float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+  dir = clamp(dir * rcpDirMin, vec2(-8.0), vec2(8.0)) * uTexelSize;
+
+  vec3 rgbA = 0.5 * (texture(screenTexture, uv + dir * (1.0 / 3.0 - 0.5)).rgb +
+                     texture(screenTexture, uv + dir * (2.0 / 3.0 - 0.5)).rgb);
+  vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(screenTexture, uv - dir * 0.5).rgb +
+                                   texture(screenTexture, uv + dir * 0.5).rgb);
+
+  float lumaB = Luma(Tonemap(rgbB));
+  return (lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB;
+}
+#endif
+
+#ifdef OUTPUT_BLOOM
+// Same 3x3 tent as the bloom upsample, so the last level is reconstructed
+// at full resolution without a blocky edge.
+vec3 Bloom(vec2 uv) {
+  vec2 d = uBloomTexelSize;
+  vec3 sum = texture(uBloomTexture, uv).rgb * 4.0;
+  sum += texture(uBloomTexture, uv + vec2(-d.x, 0.0)).rgb * 2.0;
+  sum += texture(uBloomTexture, uv + vec2(d.x, 0.0)).rgb * 2.0;
+  sum += texture(uBloomTexture, uv + vec2(0.0, -d.y)).rgb * 2.0;
+  sum += texture(uBloomTexture, uv + vec2(0.0, d.y)).rgb * 2.0;
+  sum += texture(uBloomTexture, uv + vec2(-d.x, -d.y)).rgb;
+  sum += texture(uBloomTexture, uv + vec2(d.x, -d.y)).rgb;
+  sum += texture(uBloomTexture, uv + vec2(-d.x, d.y)).rgb;
+  sum += texture(uBloomTexture, uv + vec2(d.x, d.y)).rgb;
+  return sum * (1.0 / 16.0);
+}
+#endif
+
+void main() {
+#ifdef OUTPUT_FXAA
+  vec3 col = Fxaa(TexCoords);
+#else
+  vec3 col = texture(screenTexture, TexCoords).rgb;
+#endif
+
+#ifdef OUTPUT_BLOOM
+  col += Bloom(TexCoords) * uBloomStrength;
+#endif
+
+  col = Tonemap(col);
+
+#ifdef OUTPUT_VIGNETTE
+  float dist = length(TexCoords - 0.5) * 1.4142136;
+  float vignette =
+      smoothstep(uVignetteRadius * 0.5, uVignetteRadius + 0.25, dist) *
+      uVignetteIntensity;
+  col *= 1.0 - clamp(vignette, 0.0, 1.0);
+#endif
+
+#ifdef OUTPUT_GRAIN
+  vec2 p = gl_FragCoord.xy + vec2(uTime * 37.0, uTime * 17.0);
+  float grain = fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453);
+  col += (grain - 0.5) * uGrainAmount;
+#endif
+
+  FragColor = vec4(col, 1.0);
+}
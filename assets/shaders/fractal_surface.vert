@@ -3,8 +3,16 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 
-uniform mat4 uView;
-uniform mat4 uProjection;
+layout(std140) uniform SceneData {
+  mat4 uView;
+  mat4 uProj;
+  vec4 uLightDirAndAmbient;
+  vec4 uCameraPos;
+  vec4 uFogColor;
+  vec4 uFogParams;
+  vec4 uFogParams2;
+};
+
 uniform mat4 uModel;
 
 out vec3 vNormal;
@@ -16,5 +24,5 @@ void main() {
   vWorldPos = worldPos.xyz;
   vNormal = normalize(mat3(transpose(inverse(uModel))) * aNormal);
   vHeight = aPos.y;
-  gl_Position = uProjection * uView * worldPos;
+  gl_Position = uProj * uView * worldPos;
 }
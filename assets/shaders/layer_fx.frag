@@ -0,0 +1,149 @@
+#version 330 core
+// Per-layer post effects, applied while the compositor draws the layer.
+// Every FX_* block is compiled in only for permutations that enable it
+// (FXBits / GetFXMask), so a layer pays only for the effects it uses.
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D screenTexture;
+uniform float opacity;
+uniform vec2 uTexelSize;
+uniform float uTime;
+
+#ifdef FX_GLOW
+uniform vec3 uGlowColor;
+uniform float uGlowIntensity;
+uniform float uGlowSize;
+#endif
+#ifdef FX_COLOR_GRADE
+uniform float uBrightness;
+uniform float uContrast;
+uniform float uSaturation;
+uniform float uHueShift; // degrees
+uniform vec3 uTintColor;
+uniform float uTintStrength;
+#endif
+#ifdef FX_DISTORTION
+uniform float uDistortionAmount;
+uniform float uDistortionFreq;
+uniform float uDistortionSpeed;
+#endif
+#ifdef FX_CHROMATIC
+uniform float uChromaticOffset; // texels
+uniform float uChromaticFalloff;
+#endif
+#ifdef FX_VIGNETTE
+uniform float uVignetteIntensity;
+uniform float uVignetteRadius;
+uniform vec3 uVignetteColor;
+#endif
+#ifdef FX_SCAN_LINES
+uniform float uScanLinesDensity;
+uniform float uScanLinesIntensity;
+uniform float uScanLinesSpeed;
+#endif
+#ifdef FX_NOISE
+uniform float uNoiseAmount;
+uniform float uNoiseSeed; // 0 when the grain is static
+#endif
+#ifdef FX_PIXELATE
+uniform float uPixelateSize; // texels
+#endif
+#ifdef FX_EDGE_GLOW
+uniform vec3 uEdgeGlowColor;
+uniform float uEdgeGlowWidth; // texels
+uniform float uEdgeGlowIntensity;
+#endif
+
+float Luma(vec3 c) { return dot(c, vec3(0.2126, 0.7152, 0.0722)); }
+
+void main() {
+  vec2 uv = TexCoords;
+
+#ifdef FX_PIXELATE
+  vec2 block = uTexelSize * uPixelateSize;
+  uv = (floor(uv / block) + 0.5) * block;
+#endif
+
+#ifdef FX_DISTORTION
+  float phase = uTime * uDistortionSpeed;
+  uv += vec2(sin(uv.y * uDistortionFreq + phase),
+             cos(uv.x * uDistortionFreq + phase)) *
+        uDistortionAmount * 0.01;
+#endif
+
+  vec4 col = texture(screenTexture, uv);
+
+#ifdef FX_CHROMATIC
+  // Red and blue are pulled apart along the direction from the centre,
+  // growing towards the edges as uChromaticFalloff increases.
+  vec2 fromCenter = uv - 0.5;
+  float edge = mix(1.0, clamp(length(fromCenter) * 2.0, 0.0, 1.0),
+                   uChromaticFalloff);
+  vec2 shift = normalize(fromCenter + vec2(1e-5)) * uChromaticOffset *
+               uTexelSize * edge;
+  col.r = texture(screenTexture, uv + shift).r;
+  col.b = texture(screenTexture, uv - shift).b;
+#endif
+
+#ifdef FX_GLOW
+  // Coverage on a ring of 8 taps, tinted: a soft halo around the shapes.
+  float halo = 0.0;
+  for (int i = 0; i < 8; ++i) {
+    float a = float(i) * 0.7853982;
+    halo += texture(screenTexture,
+                    uv + vec2(cos(a), sin(a)) * uGlowSize * uTexelSize).a;
+  }
+  halo *= 0.125 * uGlowIntensity;
+  col.rgb += uGlowColor * halo;
+  col.a = max(col.a, clamp(halo, 0.0, 1.0));
+#endif
+
+#ifdef FX_EDGE_GLOW
+  vec2 dx = vec2(uEdgeGlowWidth * uTexelSize.x, 0.0);
+  vec2 dy = vec2(0.0, uEdgeGlowWidth * uTexelSize.y);
+  float gx = Luma(texture(screenTexture, uv + dx).rgb) -
+             Luma(texture(screenTexture, uv - dx).rgb);
+  float gy = Luma(texture(screenTexture, uv + dy).rgb) -
+             Luma(texture(screenTexture, uv - dy).rgb);
+  float edgeGlow = length(vec2(gx, gy)) * uEdgeGlowIntensity;
+  col.rgb += uEdgeGlowColor * edgeGlow;
+  col.a = max(col.a, clamp(edgeGlow, 0.0, 1.0));
+#endif
+
+#ifdef FX_COLOR_GRADE
+  col.rgb *= uBrightness;
+  col.rgb = (col.rgb - 0.5) * uContrast + 0.5;
+  col.rgb = mix(vec3(Luma(col.rgb)), col.rgb, uSaturation);
+  // Hue rotation about the grey axis (Rodrigues' formula).
+  float angle = radians(uHueShift);
+  const vec3 k = vec3(0.57735027);
+  float c = cos(angle);
+  col.rgb = col.rgb * c + cross(k, col.rgb) * sin(angle) +
+            k * dot(k, col.rgb) * (1.0 - c);
+  col.rgb = mix(col.rgb, col.rgb * uTintColor, uTintStrength);
+  col.rgb = max(col.rgb, vec3(0.0));
+#endif
+
+#ifdef FX_SCAN_LINES
+  float line = sin((TexCoords.y * uScanLinesDensity + uTime * uScanLinesSpeed) *
+                   6.2831853);
+  col.rgb *= 1.0 - uScanLinesIntensity * (0.5 + 0.5 * line);
+#endif
+
+#ifdef FX_VIGNETTE
+  float dist = length(TexCoords - 0.5) * 1.4142136;
+  float vignette =
+      smoothstep(uVignetteRadius * 0.5, uVignetteRadius + 0.25, dist) *
+      uVignetteIntensity;
+  col.rgb = mix(col.rgb, uVignetteColor, clamp(vignette, 0.0, 1.0));
+#endif
+
+#ifdef FX_NOISE
+  vec2 p = gl_FragCoord.xy + vec2(uNoiseSeed * 37.0, uNoiseSeed * 17.0);
+  float grain = fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453);
+  col.rgb += (grain - 0.5) * uNoiseAmount;
+#endif
+
+  FragColor = vec4(col.rgb, col.a * opacity);
+}
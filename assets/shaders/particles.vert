@@ -1,12 +1,20 @@
 #version 330 core
 
 layout(location = 0) in vec3 aBase;
+// Relative to uEmitterOrigin; the compact instance format stores it as
+// half floats.
 layout(location = 1) in vec3 aInstancePos;
 layout(location = 2) in vec4 aInstanceColor;
 layout(location = 3) in float aInstanceSize;
+// GPU simulation paths only; the CPU path extrapolates while packing and
+// leaves this attribute disabled (reads as zero).
+layout(location = 4) in vec3 aInstanceVel;
 
 out vec4 vColor;
 
+uniform vec3 uEmitterOrigin;
+uniform float uExtrapolate; // seconds since the last simulation step
+
 layout(std140) uniform SceneData {
   mat4 uView;
   mat4 uProj;
@@ -18,7 +26,17 @@ layout(std140) uniform SceneData {
 };
 
 void main() {
-  vec3 worldPos = aBase + aInstancePos;
+  // GPU-simulated slots that are currently dead have size 0; push them
+  // outside the clip volume so they are culled before rasterization.
+  if (aInstanceSize <= 0.0) {
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    gl_PointSize = 1.0;
+    vColor = vec4(0.0);
+    return;
+  }
+
+  vec3 worldPos =
+      aBase + uEmitterOrigin + aInstancePos + aInstanceVel * uExtrapolate;
   gl_Position = uProj * uView * vec4(worldPos, 1.0);
   gl_PointSize = aInstanceSize;
   vColor = aInstanceColor;
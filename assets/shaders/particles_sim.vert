@@ -0,0 +1,90 @@
+#version 330 core
+
+// GPU particle simulation (transform feedback path for GL 3.3). Same logic as
+// particles_sim.comp: each vertex is one particle slot, read from the current
+// state buffer and written to the other one with rasterization disabled.
+
+layout(location = 0) in vec4 aPosLife;
+layout(location = 1) in vec4 aVelSize;
+layout(location = 2) in vec4 aColor;
+
+layout(std140) uniform ParticleSim {
+  vec4 uMetrics; // smoothed cpu, ram, disk, net (0-1)
+  vec4 uStep;    // dt, gravity, min life, max life
+  uvec4 uSpawn;  // first spawn slot, spawn count, capacity, frame seed
+};
+
+out vec4 vPosLife;
+out vec4 vVelSize;
+out vec4 vColor;
+
+const float kTwoPi = 6.28318530718;
+
+uint Hash(uint x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+float Random01(inout uint state) {
+  state = Hash(state);
+  return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+float RandomRange(inout uint state, float minValue, float maxValue) {
+  return minValue + (maxValue - minValue) * Random01(state);
+}
+
+void Spawn(uint index) {
+  uint state = Hash(index ^ (uSpawn.w * 0x9e3779b9u));
+  float cpu = uMetrics.x;
+  float ram = uMetrics.y;
+  float disk = uMetrics.z;
+  float net = uMetrics.w;
+
+  float theta = RandomRange(state, 0.0, kTwoPi);
+  float phi = acos(1.0 - 2.0 * Random01(state));
+  float radius = RandomRange(state, 0.5, 2.0 + cpu * 1.2);
+
+  float speed = 0.5 + disk * 3.0;
+  float verticalBias = 0.5 + cpu * 0.8;
+
+  vPosLife.xyz = vec3(cos(theta) * sin(phi) * radius, cos(phi) * radius * 0.6,
+                      sin(theta) * sin(phi) * radius);
+  vVelSize.x = RandomRange(state, -1.0, 1.0) * speed;
+  vVelSize.y = (RandomRange(state, 0.2, 1.0) + verticalBias) * speed;
+  vVelSize.z = RandomRange(state, -1.0, 1.0) * speed;
+  vColor = vec4(0.2 + ram * 0.8, 0.35 + (1.0 - ram) * 0.4, 0.6 + cpu * 0.4,
+                0.2 + net * 0.8);
+  vVelSize.w = 2.0 + cpu * 6.0 + net * 4.0;
+  vPosLife.w = RandomRange(state, uStep.z, uStep.w);
+}
+
+void main() {
+  uint index = uint(gl_VertexID);
+  uint capacity = uSpawn.z;
+
+  vPosLife = aPosLife;
+  vVelSize = aVelSize;
+  vColor = aColor;
+
+  uint ringOffset = (index + capacity - uSpawn.x) % capacity;
+  if (ringOffset < uSpawn.y) {
+    Spawn(index);
+  } else if (vPosLife.w <= 0.0) {
+    return;
+  }
+
+  float dt = uStep.x;
+  vPosLife.w -= dt;
+  vVelSize.y += uStep.y * dt;
+  vPosLife.xyz += vVelSize.xyz * dt;
+  vColor.a = clamp(vPosLife.w / uStep.w, 0.0, 1.0);
+  if (vPosLife.w <= 0.0) {
+    vVelSize.w = 0.0;
+    vColor.a = 0.0;
+  }
+}
@@ -0,0 +1,28 @@
+#version 330 core
+// Trail/persistence history (TrailRenderer). The default variant writes the
+// new history at half resolution: this frame's layer or last frame's
+// history faded by uFade (trailsFade scaled to the frame time), whichever
+// is brighter. The TRAILS_APPLY variant draws the history back onto the
+// layer with GL_MAX blending; the history has no alpha, so coverage is
+// taken from brightness.
+in vec2 vTexCoord;
+out vec4 FragColor;
+
+uniform sampler2D uSource; // History (apply) or the layer (accumulate)
+
+#ifndef TRAILS_APPLY
+uniform sampler2D uHistory;
+uniform float uFade;
+#endif
+
+void main() {
+#ifdef TRAILS_APPLY
+  vec3 trail = texture(uSource, vTexCoord).rgb;
+  FragColor = vec4(trail, clamp(max(trail.r, max(trail.g, trail.b)), 0.0, 1.0));
+#else
+  // One bilinear tap at a half-resolution pixel averages 2x2 layer texels.
+  vec3 current = texture(uSource, vTexCoord).rgb;
+  vec3 history = texture(uHistory, vTexCoord).rgb * uFade;
+  FragColor = vec4(max(current, history), 1.0);
+#endif
+}
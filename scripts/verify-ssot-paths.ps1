@@ -66,7 +66,7 @@ if (-not (Test-Path (Join-Path $root ".out\build"))) {
 }
 
 $outEntries = Get-ChildItem -Path (Join-Path $root ".out") -Force -ErrorAction SilentlyContinue
-$allowedOut = @("build", "logs", "artifacts", "toolchains")
+$allowedOut = @("build", "logs", "artifacts", "toolchains", "cache")
 foreach ($entry in $outEntries) {
   if ($allowedOut -notcontains $entry.Name) {
     $failures.Add("Unexpected .out entry: $($entry.Name)")
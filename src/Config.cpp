@@ -9,6 +9,12 @@
 #include <windows.h>
 
 namespace {
+// Fixed simulation rate bounds. The engine runs at most four steps per
+// frame, so a rate far above the refresh rate falls behind and plays in
+// slow motion; a rate far below it makes the interpolated motion mushy.
+constexpr float kMinSimulationHz = 10.0f;
+constexpr float kMaxSimulationHz = 240.0f;
+
 std::string Trim(const std::string &input) {
   const auto first = input.find_first_not_of(" \t\r\n");
   if (first == std::string::npos) {
@@ -79,6 +85,38 @@ std::string QualityToString(QualityTier tier) {
   }
   return "high";
 }
+
+ParticleSimMode ParseParticleSim(const std::string &value,
+                                 ParticleSimMode fallback) {
+  const std::string normalized = ToLower(Trim(value));
+  if (normalized == "auto") {
+    return ParticleSimMode::Auto;
+  }
+  if (normalized == "cpu") {
+    return ParticleSimMode::Cpu;
+  }
+  if (normalized == "compute" || normalized == "gpu") {
+    return ParticleSimMode::Compute;
+  }
+  if (normalized == "feedback" || normalized == "transform_feedback") {
+    return ParticleSimMode::TransformFeedback;
+  }
+  return fallback;
+}
+
+std::string ParticleSimToString(ParticleSimMode mode) {
+  switch (mode) {
+  case ParticleSimMode::Auto:
+    return "auto";
+  case ParticleSimMode::Cpu:
+    return "cpu";
+  case ParticleSimMode::Compute:
+    return "compute";
+  case ParticleSimMode::TransformFeedback:
+    return "feedback";
+  }
+  return "auto";
+}
 } // namespace
 
 // MeshType conversion functions (public)
@@ -194,8 +232,20 @@ Config LoadConfig() {
       config.bloomStrength = ParseFloat(value, config.bloomStrength);
     } else if (key == "exposure") {
       config.exposure = ParseFloat(value, config.exposure);
+    } else if (key == "tonemap") {
+      config.tonemapEnabled = ParseBool(value, config.tonemapEnabled);
     } else if (key == "fxaa") {
       config.fxaaEnabled = ParseBool(value, config.fxaaEnabled);
+    } else if (key == "vignette") {
+      config.vignetteEnabled = ParseBool(value, config.vignetteEnabled);
+    } else if (key == "vignette_intensity") {
+      config.vignetteIntensity = ParseFloat(value, config.vignetteIntensity);
+    } else if (key == "vignette_radius") {
+      config.vignetteRadius = ParseFloat(value, config.vignetteRadius);
+    } else if (key == "grain") {
+      config.grainEnabled = ParseBool(value, config.grainEnabled);
+    } else if (key == "grain_amount") {
+      config.grainAmount = ParseFloat(value, config.grainAmount);
     }
     // Fog
     else if (key == "fog") {
@@ -208,6 +258,10 @@ Config LoadConfig() {
       config.particlesEnabled = ParseBool(value, config.particlesEnabled);
     } else if (key == "particle_count") {
       config.particleCount = ParseInt(value, config.particleCount);
+    } else if (key == "particle_sim") {
+      config.particleSim = ParseParticleSim(value, config.particleSim);
+    } else if (key == "particle_budget_ms") {
+      config.particleBudgetMs = ParseFloat(value, config.particleBudgetMs);
     } else if (key == "fractal_enabled") {
       config.fractalEnabled = ParseBool(value, config.fractalEnabled);
     } else if (key == "fractal_response") {
@@ -222,6 +276,12 @@ Config LoadConfig() {
     // Scene
     else if (key == "rotation_speed") {
       config.rotationSpeed = ParseFloat(value, config.rotationSpeed);
+    } else if (key == "simulation_hz") {
+      // 0 (or less) keeps the variable step.
+      const float rate = ParseFloat(value, config.simulationRate);
+      config.simulationRate =
+          rate <= 0.0f ? 0.0f
+                       : std::clamp(rate, kMinSimulationHz, kMaxSimulationHz);
     }
     // Camera
     else if (key == "camera_distance") {
@@ -253,6 +313,11 @@ Config LoadConfig() {
       config.cpuMetric.meshType = StringToMeshType(value);
     } else if (key == "cpu_grid_size") {
       config.cpuGridSize = ParseInt(value, config.cpuGridSize);
+    } else if (key == "cpu_gpu_displacement") {
+      config.cpuGpuDisplacement = ParseBool(value, config.cpuGpuDisplacement);
+    } else if (key == "cpu_gpu_grid_size") {
+      config.cpuGpuGridSize =
+          std::clamp(ParseInt(value, config.cpuGpuGridSize), 2, 512);
     } else if (key == "cpu_y_offset") {
       config.cpuYOffset = ParseFloat(value, config.cpuYOffset);
     } else if (key == "cpu_spectrum") {
@@ -391,7 +456,13 @@ bool SaveConfig(const Config &config) {
   file << "bloom_threshold=" << config.bloomThreshold << "\n";
   file << "bloom_strength=" << config.bloomStrength << "\n";
   file << "exposure=" << config.exposure << "\n";
-  file << "fxaa=" << (config.fxaaEnabled ? "true" : "false") << "\n\n";
+  file << "tonemap=" << (config.tonemapEnabled ? "true" : "false") << "\n";
+  file << "fxaa=" << (config.fxaaEnabled ? "true" : "false") << "\n";
+  file << "vignette=" << (config.vignetteEnabled ? "true" : "false") << "\n";
+  file << "vignette_intensity=" << config.vignetteIntensity << "\n";
+  file << "vignette_radius=" << config.vignetteRadius << "\n";
+  file << "grain=" << (config.grainEnabled ? "true" : "false") << "\n";
+  file << "grain_amount=" << config.grainAmount << "\n\n";
 
   file << "# Fog\n";
   file << "fog=" << (config.fogEnabled ? "true" : "false") << "\n";
@@ -399,7 +470,11 @@ bool SaveConfig(const Config &config) {
 
   file << "# Particles\n";
   file << "particles=" << (config.particlesEnabled ? "true" : "false") << "\n";
-  file << "particle_count=" << config.particleCount << "\n\n";
+  file << "particle_count=" << config.particleCount << "\n";
+  file << "# Particle simulation: auto, cpu, compute, feedback\n";
+  file << "particle_sim=" << ParticleSimToString(config.particleSim) << "\n";
+  file << "# Particle frame-time budget in ms (0 = unlimited)\n";
+  file << "particle_budget_ms=" << config.particleBudgetMs << "\n\n";
 
   file << "# Fractal Visualization\n";
   file << "fractal_enabled=" << (config.fractalEnabled ? "true" : "false")
@@ -410,7 +485,9 @@ bool SaveConfig(const Config &config) {
   file << "fractal_seed=" << config.fractalSeed << "\n\n";
 
   file << "# Scene\n";
-  file << "rotation_speed=" << config.rotationSpeed << "\n\n";
+  file << "rotation_speed=" << config.rotationSpeed << "\n";
+  file << "# Fixed simulation rate in Hz (0 = update every frame)\n";
+  file << "simulation_hz=" << config.simulationRate << "\n\n";
 
   file << "# Camera\n";
   file << "camera_distance=" << config.cameraDistance << "\n";
@@ -431,6 +508,9 @@ bool SaveConfig(const Config &config) {
   file << "cpu_strength=" << config.cpuMetric.strength << "\n";
   file << "cpu_mesh=" << MeshTypeToString(config.cpuMetric.meshType) << "\n";
   file << "cpu_grid_size=" << config.cpuGridSize << "\n";
+  file << "cpu_gpu_displacement="
+       << (config.cpuGpuDisplacement ? "true" : "false") << "\n";
+  file << "cpu_gpu_grid_size=" << config.cpuGpuGridSize << "\n";
   file << "cpu_y_offset=" << config.cpuYOffset << "\n";
   file << "cpu_spectrum=" << (config.cpuSpectrum ? "true" : "false") << "\n\n";
 
@@ -11,6 +11,15 @@ enum class QualityTier {
   High = 2,
 };
 
+// Where the particle simulation runs. Auto prefers compute shaders (GL 4.3+),
+// then transform feedback (GL 3.3), then the CPU.
+enum class ParticleSimMode {
+  Auto = 0,
+  Cpu = 1,
+  Compute = 2,
+  TransformFeedback = 3,
+};
+
 // Mesh types available for metric visualizations
 enum class MeshType {
   Sphere = 0,
@@ -36,7 +45,13 @@ struct Config {
   float bloomThreshold = 0.7f;
   float bloomStrength = 0.8f;
   float exposure = 1.0f;
+  bool tonemapEnabled = true;
   bool fxaaEnabled = true;
+  bool vignetteEnabled = false;
+  float vignetteIntensity = 0.3f;
+  float vignetteRadius = 0.8f;
+  bool grainEnabled = false;
+  float grainAmount = 0.03f;
 
   // Fog
   bool fogEnabled = true;
@@ -45,6 +60,8 @@ struct Config {
   // Particles
   bool particlesEnabled = true;
   int particleCount = 6000;
+  ParticleSimMode particleSim = ParticleSimMode::Auto;
+  float particleBudgetMs = 4.0f; // Frame-time budget for particles, 0 = off
 
   // Fractal-driven visualization controls
   bool fractalEnabled = true;
@@ -55,6 +72,7 @@ struct Config {
 
   // Scene
   float rotationSpeed = 0.2f;
+  float simulationRate = 30.0f; // Fixed update rate in Hz, 0 = every frame
 
   // Camera
   float cameraDistance = 12.0f;
@@ -70,6 +88,8 @@ struct Config {
   // Metric Visualizations
   MetricConfig cpuMetric = {true, 0.0f, 1.0f, MeshType::Sphere};
   int cpuGridSize = 80;     // Resolution of the grid (X/Z)
+  bool cpuGpuDisplacement = true; // Displace a static grid in the shader
+  int cpuGpuGridSize = 256;       // Grid resolution of the GPU path
   float cpuYOffset = -3.0f; // Vertical Position
   bool cpuSpectrum = true;  // Use ROYGBIV spectrum
 
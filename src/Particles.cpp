@@ -1,40 +1,140 @@
 #include "Particles.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <random>
 
+#include "Logger.h"
 #include "SystemMonitor.h"
+#include "engine/Simd.h"
+#include "graphics/GLCapabilities.h"
+#include "graphics/GLStateCache.h"
+#include "graphics/SceneUniforms.h"
 #include "graphics/Shader.h"
 
-
 namespace {
-constexpr float kTwoPi = 6.28318530718f;
+constexpr std::size_t kSphereTableSize = 1024;
 constexpr float kMinLife = 1.0f;
 constexpr float kMaxLife = 3.5f;
+constexpr float kGravity = 0.4f;
+constexpr GLuint kSimWorkGroupSize = 256;
+
+// Budget controller tuning. Shrink quickly when over budget, grow slowly
+// once comfortably under it, and hold inside the band in between so the
+// particle density does not oscillate.
+constexpr float kBudgetLowWater = 0.75f;
+constexpr float kShrinkDelaySeconds = 0.5f;
+constexpr float kGrowDelaySeconds = 2.0f;
+constexpr float kShrinkFactor = 0.85f;
+constexpr float kGrowFactor = 1.05f;
+constexpr std::size_t kMinLiveCap = 256;
+constexpr float kCostSmoothing = 0.1f;
+
+using Clock = std::chrono::steady_clock;
+
+float MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+// lowbias32 integer hash, the same one particles_sim.comp uses.
+inline std::uint32_t Hash(std::uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+// Top / bottom 16 bits of a hash as a value in [0, 1). Converted through
+// int because SSE2/AVX2 have no unsigned-to-float instruction.
+inline float HighUnit(std::uint32_t bits) {
+  return static_cast<float>(static_cast<int>(bits >> 16)) * (1.0f / 65536.0f);
+}
+inline float LowUnit(std::uint32_t bits) {
+  return static_cast<float>(static_cast<int>(bits & 0xFFFFu)) *
+         (1.0f / 65536.0f);
+}
+
+// Unit directions spread evenly over the sphere (Fibonacci lattice), stored
+// as separate x/y/z streams. Replaces the per-particle acos/cos/sin.
+struct SphereTable {
+  float x[kSphereTableSize];
+  float y[kSphereTableSize];
+  float z[kSphereTableSize];
+
+  SphereTable() {
+    const float goldenAngle = kPi * (3.0f - std::sqrt(5.0f));
+    for (std::size_t i = 0; i < kSphereTableSize; ++i) {
+      const float cosPhi =
+          1.0f - 2.0f * (static_cast<float>(i) + 0.5f) /
+                     static_cast<float>(kSphereTableSize);
+      const float sinPhi = std::sqrt(std::max(0.0f, 1.0f - cosPhi * cosPhi));
+      const float theta = goldenAngle * static_cast<float>(i);
+      x[i] = std::cos(theta) * sinPhi;
+      y[i] = cosPhi;
+      z[i] = std::sin(theta) * sinPhi;
+    }
+  }
+};
+
+const SphereTable &GetSphereTable() {
+  static const SphereTable table;
+  return table;
+}
+
+std::uint8_t ToUnorm8(float value) {
+  return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f +
+                                   0.5f);
+}
 } // namespace
 
+void Particles::ParticleStreams::Resize(std::size_t capacity) {
+  const std::size_t padded = Simd::RoundUpToLanes(capacity);
+  for (std::vector<float> *stream :
+       {&posX, &posY, &posZ, &velX, &velY, &velZ, &colorR, &colorG, &colorB,
+        &colorA, &size, &life}) {
+    stream->assign(padded, 0.0f);
+  }
+}
+
+void Particles::ParticleStreams::MoveRange(std::size_t from, std::size_t count,
+                                           std::size_t to) {
+  for (std::vector<float> *stream :
+       {&posX, &posY, &posZ, &velX, &velY, &velZ, &colorR, &colorG, &colorB,
+        &colorA, &size, &life}) {
+    std::copy(stream->begin() + from, stream->begin() + from + count,
+              stream->begin() + to);
+  }
+}
+
 Particles::Particles(std::size_t maxParticles)
-    : maxParticles_(maxParticles), particles_(maxParticles),
-      instances_(maxParticles), rng_(std::random_device{}()),
-      uniform01_(0.0f, 1.0f) {}
+    : maxParticles_(maxParticles), rngSeed_(std::random_device{}()),
+      liveCap_(maxParticles) {}
 
 Particles::~Particles() { Cleanup(); }
 
+void Particles::SetQuality(QualityTier quality) {
+  instanceFormat_ = (quality == QualityTier::High) ? InstanceFormat::Full
+                                                   : InstanceFormat::Compact;
+}
+
 bool Particles::Initialize() {
-  GLint major = 0;
-  GLint minor = 0;
-  glGetIntegerv(GL_MAJOR_VERSION, &major);
-  glGetIntegerv(GL_MINOR_VERSION, &minor);
-  gpuSimulationAvailable_ = (major > 4) || (major == 4 && minor >= 3);
-
-  shader_ = new Shader("assets/shaders/particles.vert",
-                       "assets/shaders/particles.frag");
-  if (!shader_ || !shader_->IsValid()) {
-    return false;
-  }
+  const GLCapabilities &caps = GLCapabilities::Get();
+  gpuSimulationAvailable_ = caps.HasVersion(4, 3);
+  // Transform feedback with a uniform block needs GL 3.1+.
+  feedbackAvailable_ = caps.HasVersion(3, 3);
+
+  // The programs build in the background; Update and Draw do nothing until
+  // PollBuild() has collected them.
+  ready_ = false;
+  buildFailed_ = false;
+  shader_ = Shader::CreateAsync("assets/shaders/particles.vert",
+                                "assets/shaders/particles.frag");
 
   glGenVertexArrays(1, &vao_);
-  glBindVertexArray(vao_);
+  GLStateCache::Get().BindVertexArray(vao_);
 
   glGenBuffers(1, &baseVbo_);
   glBindBuffer(GL_ARRAY_BUFFER, baseVbo_);
@@ -43,55 +143,287 @@ bool Particles::Initialize() {
   glEnableVertexAttribArray(0);
   glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(baseVertex),
                         reinterpret_cast<void *>(0));
+  GLStateCache::Get().BindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-  glGenBuffers(1, &instanceVbo_);
-  glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
-  glBufferData(GL_ARRAY_BUFFER, maxParticles_ * sizeof(InstanceData), nullptr,
-               GL_DYNAMIC_DRAW);
+  // Start on the requested path; compute needs GL 4.3. A simulation program
+  // that fails to build falls back towards the CPU in PollBuild().
+  bool started = false;
+  const ParticleSimMode mode = requestedMode_;
+  if ((mode == ParticleSimMode::Auto || mode == ParticleSimMode::Compute) &&
+      gpuSimulationAvailable_) {
+    started = InitializeGpuSimulation(ParticleSimMode::Compute);
+  }
+  if (!started && mode != ParticleSimMode::Cpu && feedbackAvailable_) {
+    started = InitializeGpuSimulation(ParticleSimMode::TransformFeedback);
+  }
+  if (!started) {
+    if (mode != ParticleSimMode::Auto && mode != ParticleSimMode::Cpu) {
+      Logger::LogS("Particles: GPU simulation unavailable, using CPU path.");
+    }
+    started = InitializeCpuSimulation();
+  }
+  if (!started) {
+    return false;
+  }
+
+  simTimer_.Create();
+  drawTimer_.Create();
+  return true;
+}
+
+// Collects the program builds started by Initialize. Returns true once the
+// system can update and draw. A simulation program that fails to link drops
+// to the next path (compute, transform feedback, CPU), whose build is then
+// collected on a later call.
+bool Particles::PollBuild() {
+  if (ready_) {
+    return true;
+  }
+  if (buildFailed_ || !shader_ || !shader_->Poll()) {
+    return false;
+  }
+  if (!shader_->IsValid()) {
+    Logger::LogS("Particles: render program failed to build.");
+    buildFailed_ = true;
+    return false;
+  }
+
+  if (activeMode_ != ParticleSimMode::Cpu) {
+    if (!simShader_->Poll()) {
+      return false;
+    }
+    if (!simShader_->IsValid()) {
+      const ParticleSimMode failed = activeMode_;
+      CleanupGpu();
+      if (failed == ParticleSimMode::Compute && feedbackAvailable_ &&
+          InitializeGpuSimulation(ParticleSimMode::TransformFeedback)) {
+        return false;
+      }
+      Logger::LogS("Particles: GPU simulation unavailable, using CPU path.");
+      if (!InitializeCpuSimulation()) {
+        buildFailed_ = true;
+        return false;
+      }
+    } else if (activeMode_ == ParticleSimMode::TransformFeedback) {
+      simShader_->BindUniformBlock("ParticleSim", 1);
+    }
+  }
+  switch (activeMode_) {
+  case ParticleSimMode::Compute:
+    Logger::LogS("Particles: using compute shader simulation.");
+    break;
+  case ParticleSimMode::TransformFeedback:
+    Logger::LogS("Particles: using transform feedback simulation.");
+    break;
+  default:
+    break;
+  }
+
+  shader_->Use();
+  shader_->BindUniformBlock("SceneData", kSceneDataBinding);
+  emitterOriginUniform_ = Uniform<Vec3>(*shader_, "uEmitterOrigin");
+  extrapolateUniform_ = Uniform<float>(*shader_, "uExtrapolate");
+  ready_ = true;
+  return true;
+}
+
+bool Particles::InitializeCpuSimulation() {
+  particles_.Resize(maxParticles_);
+  if (!instanceStream_.Create(GL_ARRAY_BUFFER,
+                              maxParticles_ * InstanceStride())) {
+    return false;
+  }
 
+  GLStateCache::Get().BindVertexArray(vao_);
   glEnableVertexAttribArray(1);
+  glVertexAttribDivisor(1, 1);
+  glEnableVertexAttribArray(2);
+  glVertexAttribDivisor(2, 1);
+  glEnableVertexAttribArray(3);
+  glVertexAttribDivisor(3, 1);
+  BindInstanceAttributes(0);
+  GLStateCache::Get().BindVertexArray(0);
+
+  activeMode_ = ParticleSimMode::Cpu;
+  return true;
+}
+
+// Points the instance attributes of vao_ (which must be bound) at the ring
+// region starting at `offset`.
+void Particles::BindInstanceAttributes(std::size_t offset) {
+  glBindBuffer(GL_ARRAY_BUFFER, instanceStream_.GetBuffer());
+  if (instanceFormat_ == InstanceFormat::Compact) {
+    const GLsizei stride = sizeof(CompactInstanceData);
+    glVertexAttribPointer(1, 3, GL_HALF_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void *>(
+                              offset + offsetof(CompactInstanceData, position)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          reinterpret_cast<void *>(
+                              offset + offsetof(CompactInstanceData, color)));
+    glVertexAttribPointer(3, 1, GL_HALF_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<void *>(
+                              offset + offsetof(CompactInstanceData, size)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return;
+  }
   glVertexAttribPointer(
       1, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-      reinterpret_cast<void *>(offsetof(InstanceData, position)));
+      reinterpret_cast<void *>(offset + offsetof(InstanceData, position)));
+  glVertexAttribPointer(
+      2, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+      reinterpret_cast<void *>(offset + offsetof(InstanceData, color)));
+  glVertexAttribPointer(
+      3, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+      reinterpret_cast<void *>(offset + offsetof(InstanceData, size)));
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Issues the simulation program build and creates the state buffers. Returns
+// false only if the build could not even be submitted; a link failure shows
+// up later in PollBuild().
+bool Particles::InitializeGpuSimulation(ParticleSimMode mode) {
+  if (mode == ParticleSimMode::Compute) {
+    simShader_ = Shader::CreateCompute("assets/shaders/particles_sim.comp");
+  } else {
+    simShader_ = Shader::CreateTransformFeedback(
+        "assets/shaders/particles_sim.vert",
+        {"vPosLife", "vVelSize", "vColor"});
+  }
+  if (!simShader_ || (!simShader_->IsPending() && !simShader_->IsValid())) {
+    simShader_.reset();
+    return false;
+  }
+
+  // Slots start dead (life 0, size 0) and are filled by the spawn ring.
+  const std::vector<GpuParticle> initial(maxParticles_, GpuParticle{});
+  const int bufferCount = (mode == ParticleSimMode::Compute) ? 1 : 2;
+  glGenBuffers(bufferCount, gpuStateBuffers_);
+  for (int i = 0; i < bufferCount; ++i) {
+    glBindBuffer(GL_ARRAY_BUFFER, gpuStateBuffers_[i]);
+    glBufferData(GL_ARRAY_BUFFER, maxParticles_ * sizeof(GpuParticle),
+                 initial.data(), GL_DYNAMIC_COPY);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glGenBuffers(1, &simParamsUbo_);
+  glBindBuffer(GL_UNIFORM_BUFFER, simParamsUbo_);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(GpuSimParams), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  glGenVertexArrays(bufferCount, gpuDrawVaos_);
+  for (int i = 0; i < bufferCount; ++i) {
+    SetupGpuDrawVao(gpuDrawVaos_[i], gpuStateBuffers_[i]);
+  }
+
+  if (mode == ParticleSimMode::TransformFeedback) {
+    glGenVertexArrays(2, gpuUpdateVaos_);
+    for (int i = 0; i < 2; ++i) {
+      GLStateCache::Get().BindVertexArray(gpuUpdateVaos_[i]);
+      glBindBuffer(GL_ARRAY_BUFFER, gpuStateBuffers_[i]);
+      for (GLuint attrib = 0; attrib < 3; ++attrib) {
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribPointer(
+            attrib, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle),
+            reinterpret_cast<void *>(attrib * 4 * sizeof(float)));
+      }
+    }
+    GLStateCache::Get().BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  gpuReadIndex_ = 0;
+  spawnHead_ = 0;
+  gpuWindow_ = static_cast<std::uint32_t>(maxParticles_);
+  activeMode_ = mode;
+  return true;
+}
+
+// Draw VAOs read the simulation state directly: position from posLife.xyz,
+// size from velSize.w and color from color, one GpuParticle per instance.
+void Particles::SetupGpuDrawVao(GLuint vao, GLuint stateBuffer) {
+  GLStateCache::Get().BindVertexArray(vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, baseVbo_);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
+                        reinterpret_cast<void *>(0));
+
+  glBindBuffer(GL_ARRAY_BUFFER, stateBuffer);
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(
+      1, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle),
+      reinterpret_cast<void *>(offsetof(GpuParticle, posLife)));
   glVertexAttribDivisor(1, 1);
 
   glEnableVertexAttribArray(2);
-  glVertexAttribPointer(
-      2, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-      reinterpret_cast<void *>(offsetof(InstanceData, color)));
+  glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle),
+                        reinterpret_cast<void *>(offsetof(GpuParticle, color)));
   glVertexAttribDivisor(2, 1);
 
   glEnableVertexAttribArray(3);
-  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-                        reinterpret_cast<void *>(offsetof(InstanceData, size)));
+  glVertexAttribPointer(
+      3, 1, GL_FLOAT, GL_FALSE, sizeof(GpuParticle),
+      reinterpret_cast<void *>(offsetof(GpuParticle, velSize) +
+                               3 * sizeof(float)));
   glVertexAttribDivisor(3, 1);
 
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  // Velocity for draw-time extrapolation (uExtrapolate).
+  glEnableVertexAttribArray(4);
+  glVertexAttribPointer(
+      4, 3, GL_FLOAT, GL_FALSE, sizeof(GpuParticle),
+      reinterpret_cast<void *>(offsetof(GpuParticle, velSize)));
+  glVertexAttribDivisor(4, 1);
 
-  shader_->Use();
-  shader_->BindUniformBlock("SceneData", 0);
+  GLStateCache::Get().BindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-  return true;
+void Particles::CleanupGpu() {
+  for (GLuint &vao : gpuUpdateVaos_) {
+    if (vao) {
+      GLStateCache::Get().OnVertexArrayDeleted(vao);
+      glDeleteVertexArrays(1, &vao);
+      vao = 0;
+    }
+  }
+  for (GLuint &vao : gpuDrawVaos_) {
+    if (vao) {
+      GLStateCache::Get().OnVertexArrayDeleted(vao);
+      glDeleteVertexArrays(1, &vao);
+      vao = 0;
+    }
+  }
+  for (GLuint &buffer : gpuStateBuffers_) {
+    if (buffer) {
+      glDeleteBuffers(1, &buffer);
+      buffer = 0;
+    }
+  }
+  if (simParamsUbo_) {
+    glDeleteBuffers(1, &simParamsUbo_);
+    simParamsUbo_ = 0;
+  }
+  simShader_.reset();
 }
 
 void Particles::Cleanup() {
-  if (instanceVbo_) {
-    glDeleteBuffers(1, &instanceVbo_);
-    instanceVbo_ = 0;
-  }
+  simTimer_.Destroy();
+  drawTimer_.Destroy();
+  CleanupGpu();
+  instanceStream_.Destroy();
   if (baseVbo_) {
     glDeleteBuffers(1, &baseVbo_);
     baseVbo_ = 0;
   }
   if (vao_) {
+    GLStateCache::Get().OnVertexArrayDeleted(vao_);
     glDeleteVertexArrays(1, &vao_);
     vao_ = 0;
   }
-  if (shader_) {
-    delete shader_;
-    shader_ = nullptr;
-  }
+  shader_.reset();
+  ready_ = false;
 }
 
 float Particles::SmoothValue(float current, float target, float dtSeconds,
@@ -104,42 +436,202 @@ float Particles::SmoothValue(float current, float target, float dtSeconds,
   return current + (target - current) * t;
 }
 
-float Particles::RandomRange(float minValue, float maxValue) {
-  return minValue + (maxValue - minValue) * uniform01_(rng_);
-}
-
-void Particles::SpawnParticle(const SmoothedMetrics &metrics) {
-  if (liveCount_ >= maxParticles_) {
+// Spawns up to `count` particles into the contiguous slice starting at
+// liveCount_. Every random value is a pure function of the particle's spawn
+// counter (no generator state carried between iterations), directions come
+// from a table instead of acos/cos/sin, and the metric terms are hoisted, so
+// the loop body is branch-free and lanes are independent. Spawns beyond
+// the live cap are dropped.
+void Particles::SpawnBatch(std::size_t count, const SmoothedMetrics &metrics) {
+  const std::size_t first = liveCount_;
+  const std::size_t cap = std::min(liveCap_, maxParticles_);
+  const std::size_t n =
+      (liveCount_ < cap) ? std::min(count, cap - liveCount_) : 0;
+  if (n == 0) {
     return;
   }
 
-  Particle &particle = particles_[liveCount_++];
-
-  const float theta = RandomRange(0.0f, kTwoPi);
-  const float phi = std::acos(1.0f - 2.0f * uniform01_(rng_));
-  const float radius = RandomRange(0.5f, 2.0f + metrics.cpu * 1.2f);
-
-  particle.position[0] = std::cos(theta) * std::sin(phi) * radius;
-  particle.position[1] = std::cos(phi) * radius * 0.6f;
-  particle.position[2] = std::sin(theta) * std::sin(phi) * radius;
-
+  const SphereTable &sphere = GetSphereTable();
+  const float *dirX = sphere.x;
+  const float *dirY = sphere.y;
+  const float *dirZ = sphere.z;
+  const float radiusMin = 0.5f;
+  const float radiusSpan = (2.0f + metrics.cpu * 1.2f) - radiusMin;
   const float speed = 0.5f + metrics.disk * 3.0f;
   const float verticalBias = 0.5f + metrics.cpu * 0.8f;
-  particle.velocity[0] = RandomRange(-1.0f, 1.0f) * speed;
-  particle.velocity[1] = (RandomRange(0.2f, 1.0f) + verticalBias) * speed;
-  particle.velocity[2] = RandomRange(-1.0f, 1.0f) * speed;
+  const float lifeSpan = kMaxLife - kMinLife;
+
+  float *posX = particles_.posX.data() + first;
+  float *posY = particles_.posY.data() + first;
+  float *posZ = particles_.posZ.data() + first;
+  float *velX = particles_.velX.data() + first;
+  float *velY = particles_.velY.data() + first;
+  float *velZ = particles_.velZ.data() + first;
+  float *life = particles_.life.data() + first;
+  const std::uint32_t counter = spawnCounter_;
+  const std::uint32_t seed = rngSeed_;
+
+  for (std::size_t j = 0; j < n; ++j) {
+    const std::uint32_t h0 = Hash((counter + static_cast<std::uint32_t>(j)) ^
+                                  seed);
+    const std::uint32_t h1 = Hash(h0 + 0x9e3779b9u);
+    const std::uint32_t h2 = Hash(h0 + 0x3c6ef372u);
+
+    const std::uint32_t dir =
+        h0 & static_cast<std::uint32_t>(kSphereTableSize - 1);
+    const float radius = radiusMin + radiusSpan * HighUnit(h1);
+    posX[j] = dirX[dir] * radius;
+    posY[j] = dirY[dir] * radius * 0.6f;
+    posZ[j] = dirZ[dir] * radius;
+
+    velX[j] = (HighUnit(h2) * 2.0f - 1.0f) * speed;
+    velY[j] = (0.2f + 0.8f * HighUnit(h0) + verticalBias) * speed;
+    velZ[j] = (LowUnit(h2) * 2.0f - 1.0f) * speed;
+
+    life[j] = kMinLife + lifeSpan * LowUnit(h1);
+  }
 
+  // Color and size only depend on the metrics, which are fixed per batch.
   const float netPulse = 0.2f + metrics.net * 0.8f;
-  particle.color[0] = 0.2f + metrics.ram * 0.8f;
-  particle.color[1] = 0.35f + (1.0f - metrics.ram) * 0.4f;
-  particle.color[2] = 0.6f + metrics.cpu * 0.4f;
-  particle.color[3] = netPulse;
+  std::fill_n(particles_.colorR.begin() + first, n, 0.2f + metrics.ram * 0.8f);
+  std::fill_n(particles_.colorG.begin() + first, n,
+              0.35f + (1.0f - metrics.ram) * 0.4f);
+  std::fill_n(particles_.colorB.begin() + first, n, 0.6f + metrics.cpu * 0.4f);
+  std::fill_n(particles_.colorA.begin() + first, n, netPulse);
+  std::fill_n(particles_.size.begin() + first, n,
+              2.0f + metrics.cpu * 6.0f + metrics.net * 4.0f);
+
+  liveCount_ += n;
+  spawnCounter_ += static_cast<std::uint32_t>(n);
+}
+
+// Advances every live particle by one step: life countdown, gravity on the
+// vertical velocity, explicit Euler position update and alpha fade. The SIMD
+// paths use exactly the same operations in the same order as the scalar loop
+// (no FMA contraction, true division for the fade) so all three produce
+// identical results (tests/ParticlesSimdTests.cpp). Dead particles are integrated too and removed afterwards
+// by CompactDead().
+void Particles::Integrate(float dtSeconds) {
+  const std::size_t count = Simd::RoundUpToLanes(liveCount_);
+  std::size_t i = 0;
+
+#if defined(SCREENSAVER_SIMD_AVX2) || defined(SCREENSAVER_SIMD_SSE2)
+  float *posX = particles_.posX.data();
+  float *posY = particles_.posY.data();
+  float *posZ = particles_.posZ.data();
+  const float *velX = particles_.velX.data();
+  float *velY = particles_.velY.data();
+  const float *velZ = particles_.velZ.data();
+  float *colorA = particles_.colorA.data();
+  float *life = particles_.life.data();
+  const float gravityStep = kGravity * dtSeconds;
+#endif
+
+#if defined(SCREENSAVER_SIMD_AVX2)
+  const __m256 dt = _mm256_set1_ps(dtSeconds);
+  const __m256 gravity = _mm256_set1_ps(gravityStep);
+  const __m256 maxLife = _mm256_set1_ps(kMaxLife);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  for (; i < count; i += 8) {
+    const __m256 l = _mm256_sub_ps(_mm256_loadu_ps(life + i), dt);
+    const __m256 vy = _mm256_add_ps(_mm256_loadu_ps(velY + i), gravity);
+    const __m256 x = _mm256_add_ps(
+        _mm256_loadu_ps(posX + i), _mm256_mul_ps(_mm256_loadu_ps(velX + i), dt));
+    const __m256 y =
+        _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(vy, dt));
+    const __m256 z = _mm256_add_ps(
+        _mm256_loadu_ps(posZ + i), _mm256_mul_ps(_mm256_loadu_ps(velZ + i), dt));
+    const __m256 fade =
+        _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(l, maxLife), zero), one);
+    _mm256_storeu_ps(life + i, l);
+    _mm256_storeu_ps(velY + i, vy);
+    _mm256_storeu_ps(posX + i, x);
+    _mm256_storeu_ps(posY + i, y);
+    _mm256_storeu_ps(posZ + i, z);
+    _mm256_storeu_ps(colorA + i, fade);
+  }
+#elif defined(SCREENSAVER_SIMD_SSE2)
+  const __m128 dt = _mm_set1_ps(dtSeconds);
+  const __m128 gravity = _mm_set1_ps(gravityStep);
+  const __m128 maxLife = _mm_set1_ps(kMaxLife);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (; i < count; i += 4) {
+    const __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), dt);
+    const __m128 vy = _mm_add_ps(_mm_loadu_ps(velY + i), gravity);
+    const __m128 x =
+        _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), dt));
+    const __m128 y = _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, dt));
+    const __m128 z =
+        _mm_add_ps(_mm_loadu_ps(posZ + i), _mm_mul_ps(_mm_loadu_ps(velZ + i), dt));
+    const __m128 fade = _mm_min_ps(_mm_max_ps(_mm_div_ps(l, maxLife), zero), one);
+    _mm_storeu_ps(life + i, l);
+    _mm_storeu_ps(velY + i, vy);
+    _mm_storeu_ps(posX + i, x);
+    _mm_storeu_ps(posY + i, y);
+    _mm_storeu_ps(posZ + i, z);
+    _mm_storeu_ps(colorA + i, fade);
+  }
+#endif
+
+  IntegrateScalar(i, count, dtSeconds);
+}
 
-  particle.size = 2.0f + metrics.cpu * 6.0f + metrics.net * 4.0f;
-  particle.life = RandomRange(kMinLife, kMaxLife);
+// The scalar reference for Integrate over [first, last); the whole range in
+// builds with SCREENSAVER_SIMD_SCALAR.
+void Particles::IntegrateScalar(std::size_t first, std::size_t last,
+                                float dtSeconds) {
+  float *posX = particles_.posX.data();
+  float *posY = particles_.posY.data();
+  float *posZ = particles_.posZ.data();
+  const float *velX = particles_.velX.data();
+  float *velY = particles_.velY.data();
+  const float *velZ = particles_.velZ.data();
+  float *colorA = particles_.colorA.data();
+  float *life = particles_.life.data();
+
+  const float gravityStep = kGravity * dtSeconds;
+  for (std::size_t i = first; i < last; ++i) {
+    life[i] -= dtSeconds;
+    velY[i] += gravityStep;
+    posX[i] += velX[i] * dtSeconds;
+    posY[i] += velY[i] * dtSeconds;
+    posZ[i] += velZ[i] * dtSeconds;
+    colorA[i] = std::clamp(life[i] / kMaxLife, 0.0f, 1.0f);
+  }
+}
+
+// Removes expired particles in batches: contiguous runs of survivors are
+// moved down with one copy per stream instead of a swap per dead particle.
+// Survivors keep their relative order.
+void Particles::CompactDead() {
+  const float *life = particles_.life.data();
+  std::size_t write = 0;
+  std::size_t read = 0;
+  while (read < liveCount_) {
+    while (read < liveCount_ && life[read] <= 0.0f) {
+      ++read;
+    }
+    const std::size_t runStart = read;
+    while (read < liveCount_ && life[read] > 0.0f) {
+      ++read;
+    }
+    const std::size_t runLength = read - runStart;
+    if (runLength > 0 && write != runStart) {
+      particles_.MoveRange(runStart, runLength, write);
+    }
+    write += runLength;
+  }
+  liveCount_ = write;
 }
 
 void Particles::Update(float dtSeconds, const SystemMonitor &monitor) {
+  if (!PollBuild()) {
+    return;
+  }
+  const Clock::time_point start = Clock::now();
+
   const float cpuTarget = static_cast<float>(monitor.GetCpuUsage() / 100.0);
   const float ramTarget = static_cast<float>(monitor.GetRamUsage() / 100.0);
   const float diskTarget = static_cast<float>(monitor.GetDiskUsage() / 100.0);
@@ -154,73 +646,313 @@ void Particles::Update(float dtSeconds, const SystemMonitor &monitor) {
                               dtSeconds, 3.0f, 1.5f);
 
   const float spawnRate =
-      40.0f + smoothed_.cpu * 200.0f + smoothed_.net * 80.0f;
+      (40.0f + smoothed_.cpu * 200.0f + smoothed_.net * 80.0f) * spawnScale_;
   spawnAccumulator_ += spawnRate * dtSeconds;
 
-  while (spawnAccumulator_ >= 1.0f) {
-    SpawnParticle(smoothed_);
-    spawnAccumulator_ -= 1.0f;
+  const float whole = std::floor(spawnAccumulator_);
+  const std::size_t spawnCount = static_cast<std::size_t>(
+      std::min(whole, static_cast<float>(maxParticles_)));
+  spawnAccumulator_ -= whole;
+
+  if (activeMode_ != ParticleSimMode::Cpu) {
+    simTimer_.Begin();
+    UpdateGpu(dtSeconds, static_cast<std::uint32_t>(spawnCount));
+    simTimer_.End();
+  } else {
+    SpawnBatch(spawnCount, smoothed_);
+    Integrate(dtSeconds);
+    CompactDead();
   }
 
-  for (std::size_t i = 0; i < liveCount_;) {
-    Particle &particle = particles_[i];
-    particle.life -= dtSeconds;
+  UpdateBudget(dtSeconds, MillisecondsSince(start));
+}
 
-    if (particle.life <= 0.0f) {
-      particles_[i] = particles_[liveCount_ - 1];
-      --liveCount_;
-      continue;
+// Adjusts liveCap_ and spawnScale_ towards the frame budget. Over budget for
+// kShrinkDelaySeconds cuts the cap by 15%; under kBudgetLowWater of the
+// budget for kGrowDelaySeconds raises it by 5%. Excess particles are not
+// killed when the cap drops, they just are not replaced as they expire, so
+// density fades instead of popping.
+void Particles::UpdateBudget(float dtSeconds, float updateCpuMs) {
+  const float cpuSample = updateCpuMs + drawCpuMs_;
+  cpuMs_ += (cpuSample - cpuMs_) * kCostSmoothing;
+
+  float gpuSample = 0.0f;
+  bool haveGpuSample = false;
+  for (const GpuTimer *timer : {&simTimer_, &drawTimer_}) {
+    if (timer->GetLastMs() >= 0.0f) {
+      gpuSample += timer->GetLastMs();
+      haveGpuSample = true;
     }
+  }
+  if (haveGpuSample) {
+    gpuMs_ += (gpuSample - gpuMs_) * kCostSmoothing;
+  }
 
-    particle.velocity[1] += 0.4f * dtSeconds;
-    particle.position[0] += particle.velocity[0] * dtSeconds;
-    particle.position[1] += particle.velocity[1] * dtSeconds;
-    particle.position[2] += particle.velocity[2] * dtSeconds;
+  if (budgetMs_ <= 0.0f || maxParticles_ == 0) {
+    liveCap_ = maxParticles_;
+    spawnScale_ = 1.0f;
+    overBudgetSeconds_ = 0.0f;
+    underBudgetSeconds_ = 0.0f;
+    return;
+  }
 
-    const float fade = std::clamp(particle.life / kMaxLife, 0.0f, 1.0f);
-    particle.color[3] = fade;
+  const float cost = cpuMs_ + gpuMs_;
+  if (cost > budgetMs_) {
+    overBudgetSeconds_ += dtSeconds;
+    underBudgetSeconds_ = 0.0f;
+  } else if (cost < budgetMs_ * kBudgetLowWater) {
+    underBudgetSeconds_ += dtSeconds;
+    overBudgetSeconds_ = 0.0f;
+  } else {
+    overBudgetSeconds_ = 0.0f;
+    underBudgetSeconds_ = 0.0f;
+  }
 
-    ++i;
+  const std::size_t minCap = std::min(kMinLiveCap, maxParticles_);
+  if (overBudgetSeconds_ >= kShrinkDelaySeconds) {
+    const float shrunk = static_cast<float>(liveCap_) * kShrinkFactor;
+    liveCap_ = std::max(minCap, static_cast<std::size_t>(shrunk));
+    overBudgetSeconds_ = 0.0f;
+  } else if (underBudgetSeconds_ >= kGrowDelaySeconds &&
+             liveCap_ < maxParticles_) {
+    const float grown = static_cast<float>(liveCap_) * kGrowFactor;
+    liveCap_ = std::min(maxParticles_, static_cast<std::size_t>(grown) + 1);
+    underBudgetSeconds_ = 0.0f;
   }
 
-  if (gpuSimulationAvailable_) {
-    // Placeholder for future GPU-driven simulation using compute or
-    // transform feedback when OpenGL 4.3+ is available.
+  // Steady-state population is spawn rate times mean lifetime, so scaling
+  // the rate with the cap keeps the spawn pressure in line with it on every
+  // path; the GPU paths also shrink their slot window to the cap.
+  spawnScale_ =
+      static_cast<float>(liveCap_) / static_cast<float>(maxParticles_);
+}
+
+Particles::BudgetStats Particles::GetBudgetStats() const {
+  BudgetStats stats;
+  stats.maxParticles = maxParticles_;
+  stats.liveCap = liveCap_;
+  stats.liveCount =
+      (activeMode_ == ParticleSimMode::Cpu) ? liveCount_ : gpuWindow_;
+  stats.spawnScale = spawnScale_;
+  stats.cpuMs = cpuMs_;
+  stats.gpuMs = gpuMs_;
+  stats.frameCostMs = cpuMs_ + gpuMs_;
+  stats.budgetMs = budgetMs_;
+  return stats;
+}
+
+// One uniform upload plus a dispatch (or a rasterizer-discarded point draw)
+// per frame. Only the first liveCap_ slots take part: new particles take the
+// next spawnCount slots of a ring over that window, and if the spawn rate
+// outruns lifetimes the oldest slots are recycled, which matches the CPU
+// path dropping spawns at the cap closely enough visually.
+void Particles::UpdateGpu(float dtSeconds, std::uint32_t spawnCount) {
+  if (maxParticles_ == 0 || !simShader_) {
+    return;
+  }
+  ResizeGpuWindow(static_cast<std::uint32_t>(
+      std::clamp<std::size_t>(liveCap_, 1, maxParticles_)));
+  const std::uint32_t capacity = gpuWindow_;
+  spawnCount = std::min(spawnCount, capacity);
+
+  GpuSimParams params{};
+  params.metrics[0] = smoothed_.cpu;
+  params.metrics[1] = smoothed_.ram;
+  params.metrics[2] = smoothed_.disk;
+  params.metrics[3] = smoothed_.net;
+  params.step[0] = dtSeconds;
+  params.step[1] = kGravity;
+  params.step[2] = kMinLife;
+  params.step[3] = kMaxLife;
+  params.spawn[0] = spawnHead_;
+  params.spawn[1] = spawnCount;
+  params.spawn[2] = capacity;
+  params.spawn[3] = ++frameSeed_;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, simParamsUbo_);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(params), &params);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, 1, simParamsUbo_);
+
+  simShader_->Use();
+  if (activeMode_ == ParticleSimMode::Compute) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gpuStateBuffers_[0]);
+    glDispatchCompute((capacity + kSimWorkGroupSize - 1) / kSimWorkGroupSize,
+                      1, 1);
+    // Draw sources the same buffer as vertex attributes.
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                    GL_SHADER_STORAGE_BARRIER_BIT);
+  } else {
+    const int writeIndex = 1 - gpuReadIndex_;
+    GLStateCache::Get().BindVertexArray(gpuUpdateVaos_[gpuReadIndex_]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0,
+                     gpuStateBuffers_[writeIndex]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(capacity));
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    gpuReadIndex_ = writeIndex;
   }
+
+  spawnHead_ = (spawnHead_ + spawnCount) % capacity;
+}
+
+// Slots leaving the window are simply no longer simulated or drawn. Slots
+// joining it still hold whatever state they had when they left, so they are
+// reset to dead first; otherwise frozen particles would reappear.
+void Particles::ResizeGpuWindow(std::uint32_t window) {
+  if (window > gpuWindow_) {
+    const std::size_t first = gpuWindow_;
+    const std::size_t count = window - gpuWindow_;
+    const std::vector<GpuParticle> dead(count, GpuParticle{});
+    glBindBuffer(GL_ARRAY_BUFFER, gpuStateBuffers_[gpuReadIndex_]);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>(first * sizeof(GpuParticle)),
+                    static_cast<GLsizeiptr>(count * sizeof(GpuParticle)),
+                    dead.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  gpuWindow_ = window;
+  spawnHead_ %= window;
 }
 
 void Particles::Draw() {
-  if (!shader_ || !shader_->IsValid() || liveCount_ == 0 || !vao_) {
+  if (!PollBuild() || !vao_) {
     return;
   }
 
-  for (std::size_t i = 0; i < liveCount_; ++i) {
-    const Particle &particle = particles_[i];
-    InstanceData &instance = instances_[i];
-    instance.position[0] = particle.position[0];
-    instance.position[1] = particle.position[1];
-    instance.position[2] = particle.position[2];
-    instance.color[0] = particle.color[0];
-    instance.color[1] = particle.color[1];
-    instance.color[2] = particle.color[2];
-    instance.color[3] = particle.color[3];
-    instance.size = particle.size;
-  }
-
-  glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
-  glBufferSubData(GL_ARRAY_BUFFER, 0, liveCount_ * sizeof(InstanceData),
-                  instances_.data());
-
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-  glDepthMask(GL_FALSE);
+  if (activeMode_ != ParticleSimMode::Cpu) {
+    // Every slot of the window is drawn; dead ones have size 0 and are
+    // culled in the vertex shader.
+    GLStateCache &gl = GLStateCache::Get();
+    gl.SetBlend(true);
+    gl.BlendFunc(GL_SRC_ALPHA, GL_ONE);
+    gl.SetDepthMask(false);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    shader_->Use();
+    emitterOriginUniform_.Set(Vec3{});
+    extrapolateUniform_.Set(extrapolateSeconds_);
+    gl.BindVertexArray(gpuDrawVaos_[gpuReadIndex_]);
+    drawTimer_.Begin();
+    glDrawArraysInstanced(GL_POINTS, 0, 1, static_cast<GLsizei>(gpuWindow_));
+    drawTimer_.End();
+    return;
+  }
+
+  if (liveCount_ == 0) {
+    drawCpuMs_ = 0.0f;
+    return;
+  }
+
+  const Clock::time_point start = Clock::now();
+  if (instanceFormat_ == InstanceFormat::Compact) {
+    UpdateEmitterOrigin();
+  }
+  void *mapped = instanceStream_.BeginWrite();
+  if (!mapped) {
+    return;
+  }
+  if (instanceFormat_ == InstanceFormat::Compact) {
+    WriteCompactInstances(static_cast<CompactInstanceData *>(mapped));
+  } else {
+    WriteInstances(static_cast<InstanceData *>(mapped));
+  }
+  instanceStream_.EndWrite();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Each pass sets the state it needs, so nothing is restored afterwards.
+  GLStateCache &gl = GLStateCache::Get();
+  gl.SetBlend(true);
+  gl.BlendFunc(GL_SRC_ALPHA, GL_ONE);
+  gl.SetDepthMask(false);
   glEnable(GL_PROGRAM_POINT_SIZE);
 
   shader_->Use();
-  glBindVertexArray(vao_);
+  if (instanceFormat_ == InstanceFormat::Compact) {
+    emitterOriginUniform_.Set(emitterOrigin_);
+  } else {
+    emitterOriginUniform_.Set(Vec3{});
+  }
+  // Already applied while packing; attribute 4 is disabled on this VAO.
+  extrapolateUniform_.Set(0.0f);
+  gl.BindVertexArray(vao_);
+  if (instanceStream_.IsPersistent()) {
+    BindInstanceAttributes(instanceStream_.GetRegionOffset());
+  }
+  drawTimer_.Begin();
   glDrawArraysInstanced(GL_POINTS, 0, 1, static_cast<GLsizei>(liveCount_));
+  drawTimer_.End();
+  instanceStream_.Fence();
+  drawCpuMs_ = MillisecondsSince(start);
+}
+
+// Packs the SoA streams into the mapped instance region. The destination is
+// write-combined memory, so every field is written exactly once, in order,
+// and nothing is read back.
+void Particles::WriteInstances(InstanceData *instances) const {
+  const float t = extrapolateSeconds_;
+  for (std::size_t i = 0; i < liveCount_; ++i) {
+    InstanceData &instance = instances[i];
+    instance.position[0] = particles_.posX[i] + particles_.velX[i] * t;
+    instance.position[1] = particles_.posY[i] + particles_.velY[i] * t;
+    instance.position[2] = particles_.posZ[i] + particles_.velZ[i] * t;
+    instance.color[0] = particles_.colorR[i];
+    instance.color[1] = particles_.colorG[i];
+    instance.color[2] = particles_.colorB[i];
+    instance.color[3] = particles_.colorA[i];
+    instance.size = particles_.size[i];
+    instance.pad[0] = 0.0f;
+    instance.pad[1] = 0.0f;
+  }
+}
+
+// Same as WriteInstances for the 12-byte layout. Life is not stored: the
+// fade it drives is already folded into color alpha.
+void Particles::WriteCompactInstances(CompactInstanceData *instances) const {
+  const float t = extrapolateSeconds_;
+  for (std::size_t i = 0; i < liveCount_; ++i) {
+    CompactInstanceData &instance = instances[i];
+    instance.position[0] = FloatToHalf(
+        particles_.posX[i] + particles_.velX[i] * t - emitterOrigin_.x);
+    instance.position[1] = FloatToHalf(
+        particles_.posY[i] + particles_.velY[i] * t - emitterOrigin_.y);
+    instance.position[2] = FloatToHalf(
+        particles_.posZ[i] + particles_.velZ[i] * t - emitterOrigin_.z);
+    instance.size = FloatToHalf(particles_.size[i]);
+    instance.color[0] = ToUnorm8(particles_.colorR[i]);
+    instance.color[1] = ToUnorm8(particles_.colorG[i]);
+    instance.color[2] = ToUnorm8(particles_.colorB[i]);
+    instance.color[3] = ToUnorm8(particles_.colorA[i]);
+  }
+}
+
+// Centre of the live particles' bounding box. Half floats keep 11 bits of
+// mantissa, so the smaller the offsets from this point the finer the steps.
+void Particles::UpdateEmitterOrigin() {
+  if (liveCount_ == 0) {
+    return;
+  }
+  const float *streams[3] = {particles_.posX.data(), particles_.posY.data(),
+                             particles_.posZ.data()};
+  float centre[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    const float *pos = streams[axis];
+    float lo = pos[0];
+    float hi = pos[0];
+    for (std::size_t i = 1; i < liveCount_; ++i) {
+      lo = std::min(lo, pos[i]);
+      hi = std::max(hi, pos[i]);
+    }
+    centre[axis] = (lo + hi) * 0.5f;
+  }
+  emitterOrigin_ = Vec3{centre[0], centre[1], centre[2]};
+}
 
-  glBindVertexArray(0);
-  glDepthMask(GL_TRUE);
-  glDisable(GL_BLEND);
+std::size_t Particles::InstanceStride() const {
+  return instanceFormat_ == InstanceFormat::Compact
+             ? sizeof(CompactInstanceData)
+             : sizeof(InstanceData);
 }
@@ -1,36 +1,109 @@
 #pragma once
 
 #include <cstddef>
-#include <random>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "Config.h"
+#include "engine/Math.h"
 #include "glad/glad.h"
+#include "graphics/GpuTimer.h"
+#include "graphics/Shader.h"
+#include "graphics/StreamingBuffer.h"
 
-class Shader;
 class SystemMonitor;
 
 // GPU-friendly particle system that uses instanced rendering.
 //
-// Particles are simulated on the CPU for now, with smoothed/decayed inputs
-// from SystemMonitor to prevent jitter from spiky telemetry values. The
-// instancing path makes it easy to swap in GPU simulation later.
+// Metrics from SystemMonitor are smoothed/decayed on the CPU to prevent jitter
+// from spiky telemetry values. The simulation itself runs in one of three
+// places:
+//   - Compute (GL 4.3+): particle state lives in a shader storage buffer that
+//     a compute shader spawns and integrates in place.
+//   - TransformFeedback (GL 3.3): the same logic in a vertex shader that
+//     ping-pongs between two state buffers with rasterization disabled.
+//   - Cpu: structure-of-arrays state advanced 4 (SSE2) or 8 (AVX2) particles
+//     per instruction (see engine/Simd.h) and packed straight into a
+//     persistently mapped instance ring (see graphics/StreamingBuffer.h).
+// On the GPU paths the CPU cost per frame is one small uniform upload and a
+// dispatch, independent of particle count, and Draw reads the state buffer
+// directly as instance attributes.
 class Particles {
 public:
   explicit Particles(std::size_t maxParticles);
   ~Particles();
 
+  // Must be called before Initialize. Auto (the default) picks the best
+  // path the driver supports; unsupported requests fall back towards Cpu.
+  void SetSimulationMode(ParticleSimMode mode) { requestedMode_ = mode; }
+  ParticleSimMode GetSimulationMode() const { return activeMode_; }
+
+  // CPU-path instance layout. Compact is 12 bytes per particle instead of
+  // 40 (half-float position relative to the emitter origin, half-float size,
+  // RGBA8 color); Low and Medium quality use it. Must be called before
+  // Initialize.
+  void SetQuality(QualityTier quality);
+
+  // Per-frame cost target for the particle system (CPU update + CPU draw
+  // packing + GPU simulation and draw). The live cap and spawn rate are
+  // lowered while the measured cost stays over budget and raised again once
+  // it has stayed well under; 0 disables the controller.
+  void SetFrameBudget(float milliseconds) { budgetMs_ = milliseconds; }
+
+  struct BudgetStats {
+    std::size_t maxParticles = 0;
+    std::size_t liveCap = 0;
+    // Particles alive on the CPU path. The GPU paths never read back, so
+    // they report the slot window they simulate and draw (the live cap).
+    std::size_t liveCount = 0;
+    float spawnScale = 1.0f;
+    float cpuMs = 0.0f;
+    float gpuMs = 0.0f;
+    float frameCostMs = 0.0f;
+    float budgetMs = 0.0f;
+  };
+  BudgetStats GetBudgetStats() const;
+
+  // With a fixed-step Update, the time between the last step and the frame
+  // being drawn. Draw moves particles forward along their velocity by this
+  // much so motion stays smooth at render rates above the step rate.
+  void SetExtrapolation(float seconds) { extrapolateSeconds_ = seconds; }
+
+  // Starts the program builds without waiting for them. Update and Draw do
+  // nothing until the builds have finished; IsReady() says when they have.
   bool Initialize();
+  bool IsReady() const { return ready_; }
   void Update(float dtSeconds, const SystemMonitor &monitor);
   void Draw();
   void Cleanup();
 
 private:
-  struct Particle {
-    float position[3] = {0.0f, 0.0f, 0.0f};
-    float velocity[3] = {0.0f, 0.0f, 0.0f};
-    float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-    float size = 1.0f;
-    float life = 0.0f;
+  friend class ParticlesTest; // tests/ParticlesSimdTests.cpp
+
+  // Structure-of-arrays particle state. Every stream is padded to a multiple
+  // of Simd::kPadLanes so kernels never need a scalar tail loop.
+  struct ParticleStreams {
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> posZ;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> velZ;
+    std::vector<float> colorR;
+    std::vector<float> colorG;
+    std::vector<float> colorB;
+    std::vector<float> colorA;
+    std::vector<float> size;
+    std::vector<float> life;
+
+    void Resize(std::size_t capacity);
+    void MoveRange(std::size_t from, std::size_t count, std::size_t to);
+  };
+
+  enum class InstanceFormat {
+    Full,
+    Compact,
   };
 
   struct InstanceData {
@@ -40,6 +113,31 @@ private:
     float pad[2];
   };
 
+  // Matches the GL_HALF_FLOAT / normalized GL_UNSIGNED_BYTE attributes set
+  // up in BindInstanceAttributes.
+  struct CompactInstanceData {
+    std::uint16_t position[3];
+    std::uint16_t size;
+    std::uint8_t color[4];
+  };
+  static_assert(sizeof(CompactInstanceData) == 12,
+                "compact instances must stay tightly packed");
+
+  // Mirrors the Particle struct in particles_sim.comp (std430) and the
+  // interleaved transform feedback outputs of particles_sim.vert.
+  struct GpuParticle {
+    float posLife[4];
+    float velSize[4];
+    float color[4];
+  };
+
+  // Mirrors the std140 ParticleSim uniform block.
+  struct GpuSimParams {
+    float metrics[4];
+    float step[4];
+    std::uint32_t spawn[4];
+  };
+
   struct SmoothedMetrics {
     float cpu = 0.0f;
     float ram = 0.0f;
@@ -49,21 +147,80 @@ private:
 
   float SmoothValue(float current, float target, float dtSeconds,
                     float riseRate, float fallRate) const;
-  float RandomRange(float minValue, float maxValue);
-  void SpawnParticle(const SmoothedMetrics &metrics);
+  void SpawnBatch(std::size_t count, const SmoothedMetrics &metrics);
+  void Integrate(float dtSeconds);
+  void IntegrateScalar(std::size_t first, std::size_t last, float dtSeconds);
+  void CompactDead();
+  std::size_t InstanceStride() const;
+  void WriteInstances(InstanceData *instances) const;
+  void WriteCompactInstances(CompactInstanceData *instances) const;
+  void UpdateEmitterOrigin();
+  void BindInstanceAttributes(std::size_t offset);
+
+  bool PollBuild();
+  bool InitializeCpuSimulation();
+  bool InitializeGpuSimulation(ParticleSimMode mode);
+  void SetupGpuDrawVao(GLuint vao, GLuint stateBuffer);
+  void UpdateGpu(float dtSeconds, std::uint32_t spawnCount);
+  void ResizeGpuWindow(std::uint32_t window);
+  void UpdateBudget(float dtSeconds, float updateCpuMs);
+  void CleanupGpu();
 
   std::size_t maxParticles_ = 0;
   std::size_t liveCount_ = 0;
-  std::vector<Particle> particles_;
-  std::vector<InstanceData> instances_;
-  std::mt19937 rng_;
-  std::uniform_real_distribution<float> uniform01_;
+  ParticleStreams particles_;
+  // Counter-based RNG state: particle n of the run draws from
+  // Hash(n ^ rngSeed_), so a batch needs no sequential generator state.
+  std::uint32_t rngSeed_ = 0;
+  std::uint32_t spawnCounter_ = 0;
   float spawnAccumulator_ = 0.0f;
   SmoothedMetrics smoothed_;
   bool gpuSimulationAvailable_ = false;
+  bool feedbackAvailable_ = false;
+  bool ready_ = false;       // Programs built and collected (PollBuild)
+  bool buildFailed_ = false; // No path could be built; stays disabled
+  ParticleSimMode requestedMode_ = ParticleSimMode::Auto;
+  ParticleSimMode activeMode_ = ParticleSimMode::Cpu;
+  InstanceFormat instanceFormat_ = InstanceFormat::Full;
+  // Compact positions are stored relative to this point so half precision
+  // is spent on the area the particles actually occupy. Recomputed every
+  // packed frame as the centre of the live particles' bounds, which follows
+  // the cloud as it rises.
+  Vec3 emitterOrigin_{};
+  float extrapolateSeconds_ = 0.0f;
 
   GLuint vao_ = 0;
   GLuint baseVbo_ = 0;
-  GLuint instanceVbo_ = 0;
-  Shader *shader_ = nullptr;
+  StreamingBuffer instanceStream_;
+  std::unique_ptr<Shader> shader_;
+  Uniform<Vec3> emitterOriginUniform_;
+  Uniform<float> extrapolateUniform_;
+
+  // GPU simulation state. The compute path uses only index 0; transform
+  // feedback reads gpuStateBuffers_[gpuReadIndex_] and writes the other.
+  GLuint gpuStateBuffers_[2] = {0, 0};
+  GLuint gpuUpdateVaos_[2] = {0, 0};
+  GLuint gpuDrawVaos_[2] = {0, 0};
+  GLuint simParamsUbo_ = 0;
+  int gpuReadIndex_ = 0;
+  std::uint32_t spawnHead_ = 0;
+  // Slots [0, gpuWindow_) are spawned into, simulated and drawn; follows
+  // liveCap_ so the budget controller scales the GPU work, not only the
+  // spawn rate.
+  std::uint32_t gpuWindow_ = 0;
+  std::uint32_t frameSeed_ = 0;
+  std::unique_ptr<Shader> simShader_;
+
+  // Budget controller (see SetFrameBudget). Costs are smoothed; the over/under
+  // timers implement the hysteresis.
+  float budgetMs_ = 0.0f;
+  std::size_t liveCap_ = 0;
+  float spawnScale_ = 1.0f;
+  float cpuMs_ = 0.0f;
+  float gpuMs_ = 0.0f;
+  float drawCpuMs_ = 0.0f;
+  float overBudgetSeconds_ = 0.0f;
+  float underBudgetSeconds_ = 0.0f;
+  GpuTimer simTimer_;
+  GpuTimer drawTimer_;
 };
@@ -2,15 +2,39 @@
 #include "../Logger.h"
 #include "../Particles.h"
 #include "../glad/glad.h"
+#include "../graphics/GLCapabilities.h"
+#include "../graphics/GLStateCache.h"
+#include "../graphics/RenderTargetPool.h"
 #include "DebugUtils.h"
+#include "ThreadPool.h"
 #include "Engine.h"
 
 #include "../visualizers/CPUVisualizer.h"
 #include "../visualizers/DiskVisualizer.h"
 #include "../visualizers/FractalSurfaceVisualizer.h"
 #include "../visualizers/RAMVisualizer.h"
+#include <algorithm>
 #include <cmath>
 
+namespace {
+// Catch-up limit per rendered frame. With dt clamped to 0.1s this only drops
+// time after a real hitch, and keeps a slow frame from triggering an ever
+// growing backlog of updates.
+constexpr int kMaxSimStepsPerFrame = 4;
+
+const char *ParticleSimName(ParticleSimMode mode) {
+  switch (mode) {
+  case ParticleSimMode::Compute:
+    return "compute";
+  case ParticleSimMode::TransformFeedback:
+    return "transform feedback";
+  case ParticleSimMode::Cpu:
+  case ParticleSimMode::Auto:
+    break;
+  }
+  return "CPU";
+}
+} // namespace
 
 Engine::Engine() { QueryPerformanceFrequency(&m_timerFreq); }
 
@@ -30,6 +54,9 @@ bool Engine::Initialize(HWND hwnd) {
   SetupShaders();
   Logger::LogS("Setting up Meshes...");
   SetupMeshes();
+  if (!m_sceneUniforms.Create(static_cast<int>(LayerIndex::Count))) {
+    Logger::LogS("Failed to create SceneData uniform buffer");
+  }
 
   // Create system monitor
   m_systemMonitor = std::make_unique<SystemMonitor>();
@@ -71,6 +98,8 @@ bool Engine::Initialize(HWND hwnd) {
     }
   }
 
+  SetupParticles();
+
   m_sceneTransform = Mat4Identity();
   return true;
 }
@@ -86,20 +115,32 @@ void Engine::Cleanup() {
 
   // Cleanup compositor
   m_compositor.Cleanup();
+  m_bloom.Cleanup();
+  m_trails.Cleanup();
+  // Every owner has released its targets by now
+  RenderTargetPool::Get().Clear();
+  // No visualizer is left to submit mesh work
+  ThreadPool::Get().Shutdown();
 
   // Cleanup meshes
   DestroyMesh(m_cubeMesh);
   DestroyMesh(m_sphereMesh);
   DestroyMesh(m_ringMesh);
+  m_sceneUniforms.Destroy();
 
   // Cleanup shaders
+  m_pendingShaders.clear();
   m_cpuShader.reset();
+  m_cpuDisplaceShader.reset();
   m_mainShader.reset();
   m_fractalShader.reset();
   m_skyboxShader.reset();
   m_postProcessShader.reset();
 
   // Cleanup particles
+  if (m_particles) {
+    LogParticleBudget();
+  }
   m_particles.reset();
 
   // Cleanup system monitor
@@ -107,6 +148,12 @@ void Engine::Cleanup() {
 
   // Destroy OpenGL context
   if (m_hrc) {
+    const auto &stats = GLStateCache::Get().GetStats();
+    Logger::LogS("GL state calls issued: " + std::to_string(stats.issued) +
+                 ", redundant filtered: " + std::to_string(stats.redundant));
+    // A new context starts from default state, not what the cache saw.
+    GLStateCache::Get().Invalidate();
+    GLStateCache::Get().ResetStats();
     wglMakeCurrent(nullptr, nullptr);
     wglDeleteContext(m_hrc);
     m_hrc = nullptr;
@@ -117,9 +164,54 @@ void Engine::Cleanup() {
   }
 }
 
+// Particles are drawn into the Network layer (see RenderLayer) and follow
+// all four metrics. A failed Initialize leaves the engine without them.
+void Engine::SetupParticles() {
+  m_particles.reset();
+  const int count = GetParticleCount(m_config);
+  if (count <= 0) {
+    return;
+  }
+  m_particles = std::make_unique<Particles>(static_cast<std::size_t>(count));
+  m_loggedParticleCap = 0;
+  m_particles->SetSimulationMode(m_config.particleSim);
+  m_particles->SetQuality(m_config.quality);
+  m_particles->SetFrameBudget(m_config.particleBudgetMs);
+  if (!m_particles->Initialize()) {
+    Logger::LogS("Failed to initialize particles");
+    m_particles.reset();
+    return;
+  }
+  Logger::LogS("Particles: " + std::to_string(count) + " building the " +
+               ParticleSimName(m_particles->GetSimulationMode()) + " path");
+}
+
+void Engine::LogParticleBudget() const {
+  const Particles::BudgetStats stats = m_particles->GetBudgetStats();
+  Logger::LogS("Particles: cap " + std::to_string(stats.liveCap) + "/" +
+               std::to_string(stats.maxParticles) + ", live " +
+               std::to_string(stats.liveCount) + ", cost " +
+               std::to_string(stats.frameCostMs) + " ms (cpu " +
+               std::to_string(stats.cpuMs) + ", gpu " +
+               std::to_string(stats.gpuMs) + "), budget " +
+               std::to_string(stats.budgetMs) + " ms");
+}
+
 void Engine::SetConfig(const Config &config) {
+  const bool particlesChanged =
+      config.particlesEnabled != m_config.particlesEnabled ||
+      config.particleCount != m_config.particleCount ||
+      config.particleSim != m_config.particleSim ||
+      config.quality != m_config.quality;
   m_config = config;
   UpdateLayersFromConfig();
+  // The simulation path and buffers are fixed at Initialize; the budget
+  // can change on the fly.
+  if (m_hrc && particlesChanged) {
+    SetupParticles();
+  } else if (m_particles) {
+    m_particles->SetFrameBudget(m_config.particleBudgetMs);
+  }
 }
 
 void Engine::UpdateLayersFromConfig() {
@@ -157,11 +249,13 @@ void Engine::Render(int width, int height) {
   if (width != m_screenWidth || height != m_screenHeight) {
     m_screenWidth = width;
     m_screenHeight = height;
-    for (auto &layer : m_layers) {
-      layer.Resize(width, height);
-    }
     m_compositor.Resize(width, height);
   }
+  // Layer targets follow the layer transforms, which the settings can change
+  // at any time; this only reallocates when a layer's size changed.
+  for (auto &layer : m_layers) {
+    layer.Resize(width, height);
+  }
 
   // Calculate delta time
   LARGE_INTEGER now;
@@ -178,18 +272,35 @@ void Engine::Render(int width, int height) {
   m_lastFrameTime = now;
   m_hasFrameTime = true;
 
+  // Pick up shader programs that finished compiling since the last frame
+  if (!m_pendingShaders.empty()) {
+    PollShaders();
+  }
+
   // Update systems
-  UpdateMetrics(dt);
+  StepSimulation(dt);
   UpdateScene(dt);
-
-  // Render to individual layers
-  RenderToLayers(width, height);
-
-  // Composite all layers
-  CompositeLayers(width, height);
-
-  // Present final result to screen
-  m_compositor.Present();
+  UpdateSceneUniforms(width, height);
+
+  // Layers -> composite -> present, as a frame graph
+  m_fxTime += dt;
+  m_compositor.SetTime(m_fxTime);
+  m_trails.SetFrameTime(dt);
+  OutputSettings output;
+  output.tonemap = m_config.tonemapEnabled;
+  output.exposure = m_config.exposure;
+  output.bloomStrength = m_config.bloomStrength;
+  output.fxaa = m_config.fxaaEnabled;
+  output.vignette = m_config.vignetteEnabled;
+  output.vignetteIntensity = m_config.vignetteIntensity;
+  output.vignetteRadius = m_config.vignetteRadius;
+  output.grain = m_config.grainEnabled;
+  output.grainAmount = m_config.grainAmount;
+  m_compositor.SetOutputSettings(output);
+  BuildFrameGraph(width, height);
+  m_frameGraph.Compile();
+  m_frameGraph.Execute();
+  RenderTargetPool::Get().EndFrame();
 
   // Swap buffers
   if (!SwapBuffers(m_hdc)) {
@@ -197,6 +308,42 @@ void Engine::Render(int width, int height) {
   }
 }
 
+// Runs UpdateMetrics at the configured fixed rate instead of once per
+// rendered frame, so high refresh rates no longer multiply simulation cost.
+// The leftover fraction of a step is handed to the visualizers so Draw can
+// interpolate. A rate of 0 keeps the old variable-step behaviour.
+void Engine::StepSimulation(float dt) {
+  const float rate = m_config.simulationRate;
+  float alpha = 1.0f;
+  if (rate <= 0.0f) {
+    UpdateMetrics(dt);
+  } else {
+    const float step = 1.0f / rate;
+    m_simAccumulator += dt;
+    int steps = 0;
+    while (m_simAccumulator >= step && steps < kMaxSimStepsPerFrame) {
+      UpdateMetrics(step);
+      m_simAccumulator -= step;
+      ++steps;
+    }
+    if (m_simAccumulator >= step) {
+      m_simAccumulator = 0.0f;
+    }
+    alpha = m_simAccumulator / step;
+  }
+
+  for (auto &layer : m_layers) {
+    if (auto *viz = layer.GetVisualizer()) {
+      viz->SetInterpolation(alpha);
+    }
+  }
+  if (m_particles) {
+    // Particles extrapolate along their velocity instead of interpolating.
+    const float stepSeconds = (rate > 0.0f) ? alpha / rate : 0.0f;
+    m_particles->SetExtrapolation(stepSeconds);
+  }
+}
+
 void Engine::UpdateMetrics(float dt) {
   if (m_systemMonitor) {
     m_systemMonitor->Update();
@@ -209,6 +356,16 @@ void Engine::UpdateMetrics(float dt) {
       viz->Update(dt, *m_systemMonitor);
     }
   }
+
+  if (m_particles && m_systemMonitor) {
+    m_particles->Update(dt, *m_systemMonitor);
+    // The budget controller moves the cap in steps; log each one.
+    const std::size_t cap = m_particles->GetBudgetStats().liveCap;
+    if (cap != m_loggedParticleCap) {
+      m_loggedParticleCap = cap;
+      LogParticleBudget();
+    }
+  }
 }
 
 void Engine::UpdateScene(float dt) {
@@ -218,102 +375,241 @@ void Engine::UpdateScene(float dt) {
     m_cameraAngle -= 360.0f;
 }
 
-void Engine::RenderToLayers(int width, int height) {
-  // Render each visualizer to its own layer
-  for (int i = 0; i < static_cast<int>(LayerIndex::Count); ++i) {
-    auto &layer = m_layers[i];
-    auto *viz = layer.GetVisualizer();
-    if (!viz)
-      continue;
+// Fills the per-layer SceneData slots and uploads them in one call. The view
+// and light are shared; only the projection differs with each layer's aspect.
+void Engine::UpdateSceneUniforms(int width, int height) {
+  const float fovDegrees =
+      (m_config.fieldOfView > 1.0f) ? m_config.fieldOfView : 45.0f;
 
-    const auto &fx = layer.GetFXConfig();
-    if (!fx.transform.visible)
-      continue;
-
-    // Bind layer's framebuffer
-    layer.BindForRendering();
+  // Rotate camera around center
+  float radius = m_config.cameraDistance;
+  float camX = std::sin(m_cameraAngle * (kPi / 180.0f)) * radius;
+  float camZ = std::cos(m_cameraAngle * (kPi / 180.0f)) * radius;
 
-    // Apply layer transform for viewport
-    int lx = static_cast<int>(fx.transform.x * width);
-    int ly = static_cast<int>(fx.transform.y * height);
-    int lw = static_cast<int>(fx.transform.width * width);
-    int lh = static_cast<int>(fx.transform.height * height);
-    if (lw <= 0 || lh <= 0) {
-      layer.Unbind();
-      continue;
-    }
-    glViewport(lx, ly, lw, lh);
-
-    // Draw visualizer
-    Shader *shaderToUse = m_mainShader.get();
-    if (i == static_cast<int>(LayerIndex::CPU) && m_cpuShader &&
-        m_cpuShader->IsValid()) {
-      shaderToUse = m_cpuShader.get();
-    } else if (i == static_cast<int>(LayerIndex::Network) && m_fractalShader &&
-        m_fractalShader->IsValid()) {
-      shaderToUse = m_fractalShader.get();
-    }
+  Vec3 eye{camX, m_config.cameraHeight, camZ};
+  Vec3 target{0.0f, 0.0f, 0.0f};
+  Vec3 up{0.0f, 1.0f, 0.0f};
+  Mat4 view = Mat4LookAt(eye, target, up);
 
-    if (shaderToUse && shaderToUse->IsValid()) {
-      shaderToUse->Use();
+  // Simple directional light (top-right-front), 0.2 minimum ambient
+  Vec3 lightDir = Vec3Normalize(Vec3{0.5f, 1.0f, 1.0f});
 
-      // Camera setup
+  for (int i = 0; i < static_cast<int>(LayerIndex::Count); ++i) {
+    const auto &transform = m_layers[i].GetFXConfig().transform;
+    int lw = static_cast<int>(transform.width * width);
+    int lh = static_cast<int>(transform.height * height);
+    float aspect = (lw > 0 && lh > 0)
+                       ? static_cast<float>(lw) / static_cast<float>(lh)
+                       : 1.0f;
+    Mat4 projection =
+        Mat4Perspective(fovDegrees * (kPi / 180.0f), aspect, 0.1f, 100.0f);
+
+    SceneData &scene = m_sceneUniforms.GetSlot(i);
+    std::copy(view.m.begin(), view.m.end(), scene.view);
+    std::copy(projection.m.begin(), projection.m.end(), scene.proj);
+    scene.lightDirAndAmbient[0] = lightDir.x;
+    scene.lightDirAndAmbient[1] = lightDir.y;
+    scene.lightDirAndAmbient[2] = lightDir.z;
+    scene.lightDirAndAmbient[3] = 0.2f;
+    scene.cameraPos[0] = eye.x;
+    scene.cameraPos[1] = eye.y;
+    scene.cameraPos[2] = eye.z;
+    scene.cameraPos[3] = 1.0f;
+  }
 
-      CheckGLError("Before Camera Setup");
+  // Log matrices once
+  static bool loggedMatrices = false;
+  if (!loggedMatrices) {
+    LogMatrix("Projection", m_sceneUniforms.GetSlot(0).proj);
+    LogMatrix("View", view.m.data());
+    loggedMatrices = true;
+  }
 
-      float aspect = static_cast<float>(lw) / static_cast<float>(lh);
-      const float fovDegrees =
-          (m_config.fieldOfView > 1.0f) ? m_config.fieldOfView : 45.0f;
-      Mat4 projection =
-          Mat4Perspective(fovDegrees * (kPi / 180.0f), aspect, 0.1f, 100.0f);
+  m_sceneUniforms.Upload();
+}
 
-      // Rotate camera around center
-      float radius = m_config.cameraDistance;
-      float camX = std::sin(m_cameraAngle * (kPi / 180.0f)) * radius;
-      float camZ = std::cos(m_cameraAngle * (kPi / 180.0f)) * radius;
+void Engine::BuildFrameGraph(int width, int height) {
+  m_frameGraph.Reset();
+  const FrameGraphResource backbuffer =
+      m_frameGraph.ImportBackbuffer(width, height);
+
+  // One pass per layer. Only visible layers are read by the composite, so
+  // the passes of hidden layers are culled.
+  m_compositeLayers.clear();
+  std::array<FrameGraphResource, static_cast<int>(LayerIndex::Count)>
+      layerTargets;
+  layerTargets.fill(kInvalidFrameGraphResource);
+  for (int i = 0; i < static_cast<int>(LayerIndex::Count); ++i) {
+    auto &layer = m_layers[i];
+    if (!layer.GetVisualizer() || !layer.HasTargets())
+      continue;
 
-      Vec3 eye{camX, m_config.cameraHeight, camZ};
-      Vec3 target{0.0f, 0.0f, 0.0f};
-      Vec3 up{0.0f, 1.0f, 0.0f};
+    const FrameGraphResource target =
+        m_frameGraph.Import(layer.GetName(), layer.GetTarget());
+    m_frameGraph.AddPass(
+        layer.GetName(),
+        [target](FrameGraph::Builder &builder) { builder.Write(target); },
+        [this, i](const FrameGraph &) { RenderLayer(i); });
+
+    if (layer.GetFXConfig().transform.visible) {
+      // Trails and bloom add onto the layer target, ahead of every reader.
+      const std::uint32_t fxMask = GetFXMask(layer.GetFXConfig());
+      if (fxMask & FXBits::Trails) {
+        m_trails.AddPass(m_frameGraph, layer, target);
+      }
+      if (fxMask & FXBits::Bloom) {
+        m_bloom.AddPass(m_frameGraph, target, layer.GetWidth(),
+                        layer.GetHeight(), layer.GetFXConfig());
+      }
+      m_compositeLayers.push_back(&layer);
+      layerTargets[i] = target;
+    }
+  }
+  LayerCompositor::SortByRenderOrder(m_compositeLayers);
+
+  // What the composite samples for each sorted layer. The fused shader has
+  // no per-layer effects, so a layer with any is first drawn through its
+  // layer_fx permutation into a transient of its size.
+  const bool fused = m_compositor.CanCompositeFused(m_compositeLayers);
+  m_compositeSources.clear();
+  for (VisualizerLayer *layer : m_compositeLayers) {
+    FrameGraphResource source = layerTargets[layer - m_layers.data()];
+    if (fused && (GetFXMask(layer->GetFXConfig()) & FXBits::LayerPass)) {
+      const FrameGraphResource fxTarget = m_frameGraph.Create(
+          "LayerFX", {layer->GetWidth(), layer->GetHeight(), GL_RGBA16F, 0});
+      m_frameGraph.AddPass(
+          "LayerFX",
+          [source, fxTarget](FrameGraph::Builder &builder) {
+            builder.Read(source);
+            builder.Write(fxTarget);
+          },
+          [this, layer, fxTarget](const FrameGraph &graph) {
+            m_compositor.ApplyLayerFX(*layer, *graph.GetTarget(fxTarget));
+          });
+      source = fxTarget;
+    }
+    m_compositeSources.push_back(source);
+  }
 
-      Mat4 view = Mat4LookAt(eye, target, up);
+  // With no output feature enabled the fused composite writes straight to
+  // the screen. Otherwise the layers are composited into an HDR target that
+  // the final pass reads once.
+  const bool bloom = m_config.bloomEnabled && m_config.bloomStrength > 0.0f;
+  if (fused && m_compositor.GetOutputMask(bloom) == 0) {
+    m_frameGraph.AddPass(
+        "CompositeFused",
+        [&](FrameGraph::Builder &builder) {
+          for (FrameGraphResource t : m_compositeSources) {
+            builder.Read(t);
+          }
+          builder.Write(backbuffer);
+        },
+        [this, backbuffer](const FrameGraph &graph) {
+          CompositeFused(graph, *graph.GetTarget(backbuffer));
+        });
+    return;
+  }
 
-      // Log matrices once
-      static bool loggedMatrices = false;
-      if (!loggedMatrices) {
-        LogMatrix("Projection", projection.m.data());
-        LogMatrix("View", view.m.data());
+  const FrameGraphResource output =
+      m_frameGraph.Create("CompositeOutput", {width, height, GL_RGBA16F, 0});
+  m_frameGraph.AddPass(
+      fused ? "CompositeFused" : "Composite",
+      [&](FrameGraph::Builder &builder) {
+        for (FrameGraphResource t : m_compositeSources) {
+          builder.Read(t);
+        }
+        builder.Write(output);
+      },
+      [this, output, fused](const FrameGraph &graph) {
+        if (fused) {
+          CompositeFused(graph, *graph.GetTarget(output));
+        } else {
+          m_compositor.Composite(m_compositeLayers, *graph.GetTarget(output));
+        }
+      });
+
+  // Screen-wide bloom: the chain is built from the composite and its
+  // half-size level is added by the final pass.
+  const FrameGraphResource bloomLevel =
+      bloom ? m_bloom.AddChainPass(m_frameGraph, output, width, height,
+                                   m_config.bloomThreshold)
+            : kInvalidFrameGraphResource;
+
+  m_frameGraph.AddPass(
+      "Present",
+      [&](FrameGraph::Builder &builder) {
+        builder.Read(output);
+        builder.Read(bloomLevel);
+        builder.Write(backbuffer);
+      },
+      [this, output, bloomLevel](const FrameGraph &graph) {
+        m_compositor.Present(*graph.GetTarget(output),
+                             graph.GetTarget(bloomLevel));
+      });
+}
 
-         GLint locView = glGetUniformLocation(shaderToUse->GetId(), "uView");
-         GLint locProj =
-             glGetUniformLocation(shaderToUse->GetId(), "uProjection");
-        std::stringstream ss;
-        ss << "Uniform locs - uView: " << locView
-           << ", uProjection: " << locProj;
-        Logger::LogS(ss.str());
+// Runs the fused composite with the textures of m_compositeSources, which
+// are only resolved while the composite pass executes.
+void Engine::CompositeFused(const FrameGraph &graph,
+                            const RenderTarget &target) {
+  GLuint textures[LayerCompositor::kMaxFusedLayers] = {};
+  for (std::size_t i = 0; i < m_compositeSources.size() &&
+                          i < LayerCompositor::kMaxFusedLayers;
+       ++i) {
+    textures[i] = graph.GetTarget(m_compositeSources[i])->colorTex;
+  }
+  m_compositor.CompositeFused(m_compositeLayers, textures, target);
+}
 
-        loggedMatrices = true;
-      }
+void Engine::RenderLayer(int i) {
+  auto &layer = m_layers[i];
+  auto *viz = layer.GetVisualizer();
+
+  // The layer's targets are sized to its transformed viewport, so the
+  // whole target is drawn; the compositor places it on screen.
+  layer.BindForRendering();
+
+  GLStateCache &gl = GLStateCache::Get();
+  // Visualizers draw opaque, depth-tested geometry; anything that needs
+  // more sets it itself.
+  gl.SetBlend(false);
+  gl.SetDepthTest(true);
+  gl.SetDepthMask(true);
+
+  // Draw visualizer
+  Shader *shaderToUse = m_mainShader.get();
+  if (i == static_cast<int>(LayerIndex::CPU) &&
+      m_config.cpuGpuDisplacement && m_cpuDisplaceShader &&
+      m_cpuDisplaceShader->IsValid()) {
+    shaderToUse = m_cpuDisplaceShader.get();
+  } else if (i == static_cast<int>(LayerIndex::CPU) && m_cpuShader &&
+      m_cpuShader->IsValid()) {
+    shaderToUse = m_cpuShader.get();
+  } else if (i == static_cast<int>(LayerIndex::Network) && m_fractalShader &&
+      m_fractalShader->IsValid()) {
+    shaderToUse = m_fractalShader.get();
+  }
 
-       shaderToUse->SetMat4("uProjection", projection.m.data());
-       shaderToUse->SetMat4("uView", view.m.data());
-       CheckGLError("After Setting Matrices");
+  if (shaderToUse && shaderToUse->IsValid()) {
+    shaderToUse->Use();
 
-       viz->Draw(shaderToUse, m_sceneTransform);
-       CheckGLError("After Draw");
-     }
+    // Camera and light come from this layer's SceneData slot
+    m_sceneUniforms.Bind(i);
+    CheckGLError("After Binding SceneData");
 
-    layer.Unbind();
+    viz->Draw(shaderToUse, m_sceneTransform);
+    CheckGLError("After Draw");
   }
-}
 
-void Engine::CompositeLayers(int width, int height) {
-  // Get layer pointers sorted by render order
-  auto layerPtrs = GetLayerPointers();
-  std::vector<VisualizerLayer *> layers(layerPtrs.begin(), layerPtrs.end());
+  // Particles share the Network layer's camera slot; they blend additively
+  // over the surface without writing depth.
+  if (i == static_cast<int>(LayerIndex::Network) && m_particles) {
+    m_sceneUniforms.Bind(i);
+    m_particles->Draw();
+    CheckGLError("After Particles Draw");
+  }
 
-  // Composite into final output
-  m_compositor.Composite(layers);
+  layer.Unbind();
 }
 
 bool Engine::InitializeOpenGLContext(HWND hwnd) {
@@ -368,33 +664,55 @@ bool Engine::InitializeOpenGLContext(HWND hwnd) {
   return true;
 }
 
+// Submits every scene program at once so the driver can compile them in
+// parallel; PollShaders() picks up the results as they finish. Until a
+// layer's own program is ready it draws with the main shader, or stays
+// cleared if that is not ready either.
 void Engine::SetupShaders() {
-  Logger::LogS("Loading CPU Surreal Shader...");
-  m_cpuShader = std::make_unique<Shader>("assets/shaders/cpu_surreal.vert",
-                                         "assets/shaders/cpu_surreal.frag");
-  if (!m_cpuShader->IsValid()) {
-    Logger::LogS("Failed to load CPU Surreal Shader.");
-  } else {
-    Logger::LogS("CPU Surreal Shader Loaded Successfully.");
+  if (GLCapabilities::Get().SupportsParallelShaderCompile() &&
+      glMaxShaderCompilerThreadsKHR) {
+    // Let the driver pick the number of compiler threads.
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
   }
 
-  Logger::LogS("Loading Main Shader...");
-  m_mainShader = std::make_unique<Shader>("assets/shaders/basic.vert",
-                                          "assets/shaders/basic.frag");
-  if (!m_mainShader->IsValid()) {
-    Logger::LogS("Failed to load Main Shader!");
-  } else {
-    Logger::LogS("Main Shader Loaded Successfully.");
-  }
-
-  Logger::LogS("Loading Fractal Surface Shader...");
+  Logger::LogS("Submitting CPU Surreal Shader...");
+  m_cpuShader = Shader::CreateAsync("assets/shaders/cpu_surreal.vert",
+                                    "assets/shaders/cpu_surreal.frag");
+  m_cpuDisplaceShader =
+      Shader::CreateAsync("assets/shaders/cpu_surreal.vert",
+                          "assets/shaders/cpu_surreal.frag",
+                          "#define GPU_DISPLACEMENT 1\n");
+  Logger::LogS("Submitting Main Shader...");
+  m_mainShader = Shader::CreateAsync("assets/shaders/basic.vert",
+                                     "assets/shaders/basic.frag");
+  Logger::LogS("Submitting Fractal Surface Shader...");
   m_fractalShader =
-      std::make_unique<Shader>("assets/shaders/fractal_surface.vert",
-                               "assets/shaders/fractal_surface.frag");
-  if (!m_fractalShader->IsValid()) {
-    Logger::LogS("Failed to load Fractal Surface Shader.");
-  } else {
-    Logger::LogS("Fractal Surface Shader Loaded Successfully.");
+      Shader::CreateAsync("assets/shaders/fractal_surface.vert",
+                          "assets/shaders/fractal_surface.frag");
+
+  m_pendingShaders = {{m_cpuShader.get(), "CPU Surreal Shader"},
+                      {m_cpuDisplaceShader.get(), "CPU Displacement Shader"},
+                      {m_mainShader.get(), "Main Shader"},
+                      {m_fractalShader.get(), "Fractal Surface Shader"}};
+  PollShaders();
+}
+
+void Engine::PollShaders() {
+  for (auto it = m_pendingShaders.begin(); it != m_pendingShaders.end();) {
+    Shader *shader = it->first;
+    if (!shader->Poll()) {
+      ++it;
+      continue;
+    }
+
+    if (shader->IsValid()) {
+      // Scene shaders read camera and light from the shared SceneData block
+      shader->BindUniformBlock("SceneData", kSceneDataBinding);
+      Logger::LogS(std::string(it->second) + " Loaded Successfully.");
+    } else {
+      Logger::LogS(std::string("Failed to load ") + it->second + ".");
+    }
+    it = m_pendingShaders.erase(it);
   }
 }
 
@@ -412,4 +730,6 @@ void Engine::SetupLayers(int width, int height) {
   }
 
   m_compositor.Initialize(width, height);
+  m_bloom.Initialize();
+  m_trails.Initialize();
 }
@@ -2,12 +2,18 @@
 
 #include "../Config.h"
 #include "../SystemMonitor.h"
+#include "../graphics/BloomRenderer.h"
+#include "../graphics/FrameGraph.h"
 #include "../graphics/LayerCompositor.h"
 #include "../graphics/Mesh.h"
+#include "../graphics/SceneUniforms.h"
+#include "../graphics/TrailRenderer.h"
 #include "../graphics/Shader.h"
 #include "../graphics/VisualizerLayer.h"
 #include <array>
 #include <memory>
+#include <utility>
+#include <vector>
 #include <windows.h>
 
 // Forward declarations
@@ -35,6 +41,8 @@ public:
 
   // Access to subsystems
   SystemMonitor *GetSystemMonitor() { return m_systemMonitor.get(); }
+  // Null when particles are disabled or failed to initialize.
+  const Particles *GetParticles() const { return m_particles.get(); }
   Shader *GetMainShader() { return m_mainShader.get(); }
 
   // Layer access
@@ -56,14 +64,20 @@ private:
   // OpenGL context setup
   bool InitializeOpenGLContext(HWND hwnd);
   void SetupShaders();
+  void PollShaders();
   void SetupMeshes();
   void SetupLayers(int width, int height);
+  void SetupParticles();
+  void LogParticleBudget() const;
 
   // Per-frame operations
+  void StepSimulation(float dt);
   void UpdateMetrics(float dt);
   void UpdateScene(float dt);
-  void RenderToLayers(int width, int height);
-  void CompositeLayers(int width, int height);
+  void UpdateSceneUniforms(int width, int height);
+  void BuildFrameGraph(int width, int height);
+  void CompositeFused(const FrameGraph &graph, const RenderTarget &target);
+  void RenderLayer(int index);
 
   // Configuration
   Config m_config;
@@ -74,11 +88,18 @@ private:
   // Subsystems
   std::unique_ptr<SystemMonitor> m_systemMonitor;
   std::unique_ptr<Particles> m_particles;
+  std::size_t m_loggedParticleCap = 0; // Budget cap last written to the log
   std::unique_ptr<Shader> m_cpuShader;
+  std::unique_ptr<Shader> m_cpuDisplaceShader; // GPU_DISPLACEMENT variant
   std::unique_ptr<Shader> m_mainShader;
   std::unique_ptr<Shader> m_fractalShader;
   std::unique_ptr<Shader> m_skyboxShader;
   std::unique_ptr<Shader> m_postProcessShader;
+  // Programs submitted by SetupShaders that have not finished building
+  std::vector<std::pair<Shader *, const char *>> m_pendingShaders;
+
+  // SceneData block contents, one slot per layer
+  SceneUniformBuffer m_sceneUniforms;
 
   // Meshes (owned by engine)
   Mesh m_cubeMesh;
@@ -88,6 +109,12 @@ private:
   // Visualizer Layers - 4 fixed layers (CPU, RAM, Disk, Network)
   std::array<VisualizerLayer, static_cast<int>(LayerIndex::Count)> m_layers;
   LayerCompositor m_compositor;
+  BloomRenderer m_bloom;
+  TrailRenderer m_trails;
+  // Rebuilt every frame by BuildFrameGraph
+  FrameGraph m_frameGraph;
+  std::vector<VisualizerLayer *> m_compositeLayers; // Visible, sorted
+  std::vector<FrameGraphResource> m_compositeSources; // Per composite layer
 
   // Scene state
   Mat4 m_sceneTransform;
@@ -97,6 +124,8 @@ private:
   LARGE_INTEGER m_timerFreq;
   LARGE_INTEGER m_lastFrameTime;
   bool m_hasFrameTime = false;
+  float m_simAccumulator = 0.0f; // Unsimulated time for the fixed step
+  float m_fxTime = 0.0f;         // Animation time for layer effects
 
   // Current screen dimensions
   int m_screenWidth = 0;
@@ -1,5 +1,7 @@
 #include "Math.h"
 
+#include <cstring>
+
 Vec3 Vec3Sub(const Vec3 &a, const Vec3 &b) {
   return {a.x - b.x, a.y - b.y, a.z - b.z};
 }
@@ -127,3 +129,44 @@ Mat4 Mat4LookAt(const Vec3 &eye, const Vec3 &target, const Vec3 &up) {
   out.m[14] = (forward.x * eye.x + forward.y * eye.y + forward.z * eye.z);
   return out;
 }
+
+std::uint16_t FloatToHalf(float value) {
+  std::uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const std::uint32_t sign = (bits >> 16) & 0x8000u;
+  const std::uint32_t absBits = bits & 0x7FFFFFFFu;
+
+  if (absBits >= 0x7F800000u) {
+    // Inf stays inf, NaN stays a (quiet) NaN.
+    return static_cast<std::uint16_t>(
+        sign | 0x7C00u | (absBits > 0x7F800000u ? 0x0200u : 0u));
+  }
+  if (absBits >= 0x477FF000u) {
+    // Rounds past 65504.
+    return static_cast<std::uint16_t>(sign | 0x7C00u);
+  }
+  if (absBits < 0x38800000u) {
+    // Below the smallest normal half: produce a subnormal (or zero).
+    if (absBits < 0x33000000u) {
+      return static_cast<std::uint16_t>(sign);
+    }
+    const std::uint32_t exponent = absBits >> 23;
+    const std::uint32_t mantissa = (absBits & 0x007FFFFFu) | 0x00800000u;
+    const std::uint32_t shift = 126u - exponent;
+    std::uint32_t half = mantissa >> shift;
+    const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+    const std::uint32_t halfway = 1u << (shift - 1u);
+    if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+      ++half;
+    }
+    return static_cast<std::uint16_t>(sign | half);
+  }
+
+  // Rebias the exponent from 127 to 15 and drop 13 mantissa bits.
+  std::uint32_t half = (absBits - 0x38000000u) >> 13;
+  const std::uint32_t remainder = absBits & 0x1FFFu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+    ++half;
+  }
+  return static_cast<std::uint16_t>(sign | half);
+}
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 
 // 3D Vector
 struct Vec3 {
@@ -18,6 +19,9 @@ struct Mat4 {
 // Constants
 constexpr float kPi = 3.14159265358979323846f;
 
+// Scalar helpers
+inline float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+
 // Vec3 operations
 Vec3 Vec3Sub(const Vec3& a, const Vec3& b);
 Vec3 Vec3Cross(const Vec3& a, const Vec3& b);
@@ -33,3 +37,7 @@ Mat4 Mat4RotateY(float radians);
 Mat4 Mat4RotateZ(float radians);
 Mat4 Mat4Perspective(float fovRadians, float aspect, float nearPlane, float farPlane);
 Mat4 Mat4LookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+
+// IEEE 754 binary16 conversion (round to nearest even), for GL_HALF_FLOAT
+// vertex data.
+std::uint16_t FloatToHalf(float value);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity history, newest first. Push() overwrites the oldest entry
+// in O(1) instead of shifting the rest; operator[](age) reads the entry
+// pushed `age` pushes ago (0 = newest).
+//
+// The storage never moves, so it can be mirrored elsewhere (e.g. into a
+// texture) by copying only the slot the last push wrote: GetHead() is the
+// storage index of the newest entry, and entry `age` lives at
+// (GetHead() + age) % GetCapacity().
+template <typename T> class RingBuffer {
+public:
+  RingBuffer() = default;
+  explicit RingBuffer(std::size_t capacity, const T &fill = T{}) {
+    Reset(capacity, fill);
+  }
+
+  // Sets the capacity and fills every entry with `fill`.
+  void Reset(std::size_t capacity, const T &fill = T{}) {
+    data_.assign(capacity, fill);
+    head_ = 0;
+  }
+
+  void Push(const T &value) {
+    if (data_.empty()) {
+      return;
+    }
+    head_ = (head_ == 0 ? data_.size() : head_) - 1;
+    data_[head_] = value;
+  }
+
+  const T &operator[](std::size_t age) const {
+    const std::size_t index = head_ + age;
+    return data_[index < data_.size() ? index : index - data_.size()];
+  }
+  const T &Newest() const { return data_[head_]; }
+
+  std::size_t GetCapacity() const { return data_.size(); }
+  bool IsEmpty() const { return data_.empty(); }
+  std::size_t GetHead() const { return head_; }
+  // Storage order, not age order; see GetHead().
+  const T *Data() const { return data_.data(); }
+
+private:
+  std::vector<T> data_;
+  std::size_t head_ = 0;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+// Compile-time SIMD selection shared by the CPU kernels.
+//
+// AVX2 is opt-in through the SCREENSAVER_ENABLE_AVX2 CMake option (which adds
+// /arch:AVX2), SSE2 is the x64 baseline, and anything else falls back to the
+// scalar loops. Define SCREENSAVER_SIMD_SCALAR to force the scalar path when
+// comparing results.
+#if !defined(SCREENSAVER_SIMD_SCALAR) && defined(__AVX2__)
+#define SCREENSAVER_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(SCREENSAVER_SIMD_SCALAR) &&                                      \
+    (defined(_M_X64) || defined(__SSE2__) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SCREENSAVER_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Simd {
+
+#if defined(SCREENSAVER_SIMD_AVX2)
+constexpr std::size_t kFloatLanes = 8;
+#elif defined(SCREENSAVER_SIMD_SSE2)
+constexpr std::size_t kFloatLanes = 4;
+#else
+constexpr std::size_t kFloatLanes = 1;
+#endif
+
+// Buffers sized with this can be processed in whole SIMD blocks without a
+// scalar tail loop.
+constexpr std::size_t kPadLanes = 8;
+
+inline std::size_t RoundUpToLanes(std::size_t count) {
+  return (count + kPadLanes - 1) / kPadLanes * kPadLanes;
+}
+
+} // namespace Simd
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "Simd.h"
+
+// Floor and approximate sine/cosine for the CPU mesh kernels, in a scalar
+// form and in the vector width selected by Simd.h. All forms run the same
+// operations in the same order (Cody-Waite reduction by pi, degree-9 odd
+// polynomial, sign from the parity of the quotient), so the SIMD and scalar
+// paths agree. The polynomial is within about 4e-6 of the true sine after
+// reduction.
+namespace Simd {
+
+namespace SinConstants {
+constexpr float kInvPi = 0.318309886183790671538f;
+// pi split so that q * kPiHi is exact for the quotients the kernels see.
+constexpr float kPiHi = 3.140625f;
+constexpr float kPiLo = 9.67653589793e-4f;
+constexpr float kHalfPi = 1.57079632679489661923f;
+constexpr float kC3 = -1.0f / 6.0f;
+constexpr float kC5 = 1.0f / 120.0f;
+constexpr float kC7 = -1.0f / 5040.0f;
+constexpr float kC9 = 1.0f / 362880.0f;
+} // namespace SinConstants
+
+inline float Sin(float x) {
+  using namespace SinConstants;
+  // nearbyint rounds to nearest even, like the SIMD float->int conversions.
+  const int q = static_cast<int>(std::nearbyint(x * kInvPi));
+  const float qf = static_cast<float>(q);
+  const float r = (x - qf * kPiHi) - qf * kPiLo;
+  const float r2 = r * r;
+  const float p = r + r * r2 * (kC3 + r2 * (kC5 + r2 * (kC7 + r2 * kC9)));
+  return (q & 1) ? -p : p;
+}
+
+inline float Cos(float x) { return Sin(x + SinConstants::kHalfPi); }
+
+// Exact for |x| < 2^31, where all forms agree with std::floor.
+inline float Floor(float x) { return std::floor(x); }
+
+#if defined(SCREENSAVER_SIMD_AVX2)
+inline __m256 Sin(__m256 x) {
+  using namespace SinConstants;
+  const __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kInvPi)));
+  const __m256 qf = _mm256_cvtepi32_ps(q);
+  const __m256 r =
+      _mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(kPiHi))),
+                    _mm256_mul_ps(qf, _mm256_set1_ps(kPiLo)));
+  const __m256 r2 = _mm256_mul_ps(r, r);
+  __m256 poly = _mm256_add_ps(_mm256_set1_ps(kC7),
+                              _mm256_mul_ps(r2, _mm256_set1_ps(kC9)));
+  poly = _mm256_add_ps(_mm256_set1_ps(kC5), _mm256_mul_ps(r2, poly));
+  poly = _mm256_add_ps(_mm256_set1_ps(kC3), _mm256_mul_ps(r2, poly));
+  const __m256 p = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), poly));
+  // Odd quotients flip the sign: move bit 0 of q into the sign bit.
+  const __m256 sign = _mm256_castsi256_ps(_mm256_slli_epi32(q, 31));
+  return _mm256_xor_ps(p, sign);
+}
+
+inline __m256 Cos(__m256 x) {
+  return Sin(_mm256_add_ps(x, _mm256_set1_ps(SinConstants::kHalfPi)));
+}
+
+inline __m256 Floor(__m256 x) { return _mm256_floor_ps(x); }
+#elif defined(SCREENSAVER_SIMD_SSE2)
+inline __m128 Sin(__m128 x) {
+  using namespace SinConstants;
+  const __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kInvPi)));
+  const __m128 qf = _mm_cvtepi32_ps(q);
+  const __m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(kPiHi))),
+                              _mm_mul_ps(qf, _mm_set1_ps(kPiLo)));
+  const __m128 r2 = _mm_mul_ps(r, r);
+  __m128 poly =
+      _mm_add_ps(_mm_set1_ps(kC7), _mm_mul_ps(r2, _mm_set1_ps(kC9)));
+  poly = _mm_add_ps(_mm_set1_ps(kC5), _mm_mul_ps(r2, poly));
+  poly = _mm_add_ps(_mm_set1_ps(kC3), _mm_mul_ps(r2, poly));
+  const __m128 p = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), poly));
+  // Odd quotients flip the sign: move bit 0 of q into the sign bit.
+  const __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(q, 31));
+  return _mm_xor_ps(p, sign);
+}
+
+inline __m128 Cos(__m128 x) {
+  return Sin(_mm_add_ps(x, _mm_set1_ps(SinConstants::kHalfPi)));
+}
+
+// SSE2 has no floor: truncate, then step down where that rounded up.
+inline __m128 Floor(__m128 x) {
+  const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+  const __m128 roundedUp = _mm_cmpgt_ps(truncated, x);
+  return _mm_sub_ps(truncated, _mm_and_ps(roundedUp, _mm_set1_ps(1.0f)));
+}
+#endif
+
+// sinOut[i] = Sin(angles[i]) and cosOut[i] = Cos(angles[i]). `count` should
+// be a multiple of kPadLanes (see RoundUpToLanes) to skip the scalar tail.
+inline void SinCos(const float *angles, float *sinOut, float *cosOut,
+                   std::size_t count) {
+  std::size_t i = 0;
+#if defined(SCREENSAVER_SIMD_AVX2)
+  for (; i + 8 <= count; i += 8) {
+    const __m256 a = _mm256_loadu_ps(angles + i);
+    _mm256_storeu_ps(sinOut + i, Sin(a));
+    _mm256_storeu_ps(cosOut + i, Cos(a));
+  }
+#elif defined(SCREENSAVER_SIMD_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    const __m128 a = _mm_loadu_ps(angles + i);
+    _mm_storeu_ps(sinOut + i, Sin(a));
+    _mm_storeu_ps(cosOut + i, Cos(a));
+  }
+#endif
+  for (; i < count; ++i) {
+    sinOut[i] = Sin(angles[i]);
+    cosOut[i] = Cos(angles[i]);
+  }
+}
+
+} // namespace Simd
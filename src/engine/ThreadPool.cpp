@@ -0,0 +1,122 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+// Set on pool workers and on a caller while it runs chunks, so nested
+// ParallelFor calls run inline instead of deadlocking on the pool.
+thread_local bool t_inParallelFor = false;
+} // namespace
+
+ThreadPool &ThreadPool::Get() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::Start() {
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  const std::size_t workers =
+      std::min<std::size_t>(hardware > 1 ? hardware - 1 : 0, kMaxWorkers);
+  std::uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+    generation = generation_;
+  }
+  // Workers start from the current generation, so a job posted before a
+  // worker first takes the lock is still picked up.
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this, generation] { WorkerLoop(generation); });
+  }
+}
+
+void ThreadPool::Shutdown() {
+  std::lock_guard<std::mutex> submitLock(submitMutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void ThreadPool::ParallelFor(std::size_t count, std::size_t grain,
+                             RangeFunction body) {
+  if (count == 0) {
+    return;
+  }
+  grain = std::max<std::size_t>(grain, 1);
+  if (t_inParallelFor || count <= grain) {
+    body(0, count);
+    return;
+  }
+
+  std::unique_lock<std::mutex> submitLock(submitMutex_);
+  if (workers_.empty()) {
+    Start();
+  }
+  if (workers_.empty()) {
+    // Single hardware thread.
+    submitLock.unlock();
+    body(0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    body_ = &body;
+    count_ = count;
+    grain_ = grain;
+    next_.store(0, std::memory_order_relaxed);
+    running_ = workers_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  t_inParallelFor = true;
+  RunChunks();
+  t_inParallelFor = false;
+
+  // Barrier: every worker has left RunChunks, so all chunks are done and
+  // their writes are visible to the caller.
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return running_ == 0; });
+  body_ = nullptr;
+}
+
+void ThreadPool::RunChunks() {
+  for (;;) {
+    const std::size_t begin =
+        next_.fetch_add(grain_, std::memory_order_relaxed);
+    if (begin >= count_) {
+      return;
+    }
+    (*body_)(begin, std::min(begin + grain_, count_));
+  }
+}
+
+void ThreadPool::WorkerLoop(std::uint64_t seen) {
+  t_inParallelFor = true;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock,
+                 [this, seen] { return stopping_ || generation_ != seen; });
+      if (stopping_) {
+        return;
+      }
+      seen = generation_;
+    }
+
+    RunChunks();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--running_ == 0) {
+      done_.notify_one();
+    }
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Persistent worker threads for the data-parallel CPU kernels (mesh rows).
+//
+// ParallelFor() splits [0, count) into chunks that the workers and the
+// calling thread claim from a shared counter, and returns once every chunk
+// has run, so consecutive calls are separated by a barrier: a pass that
+// reads what the previous one wrote (normals after heights) simply goes in
+// a second call.
+//
+// The workers are started on first use, one per hardware thread beside the
+// caller (capped at kMaxWorkers), and sleep between calls. Calls made from
+// inside a ParallelFor body, or while the pool is shut down, run inline.
+class ThreadPool {
+public:
+  static constexpr std::size_t kMaxWorkers = 15;
+
+  // Non-owning reference to a callable taking (begin, end): an object
+  // pointer plus a trampoline, so passing a capturing lambda never
+  // allocates. The callable must outlive the ParallelFor call, which a
+  // lambda written in the call's argument list always does.
+  class RangeFunction {
+  public:
+    template <typename F,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<F>, RangeFunction>>>
+    RangeFunction(const F &body) : object_(&body), call_(&Call<F>) {}
+
+    void operator()(std::size_t begin, std::size_t end) const {
+      call_(object_, begin, end);
+    }
+
+  private:
+    template <typename F>
+    static void Call(const void *object, std::size_t begin, std::size_t end) {
+      (*static_cast<const F *>(object))(begin, end);
+    }
+
+    const void *object_;
+    void (*call_)(const void *, std::size_t, std::size_t);
+  };
+
+  static ThreadPool &Get();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Calls body(begin, end) for chunks of at most `grain` indices covering
+  // [0, count). Chunks run concurrently and in no particular order.
+  void ParallelFor(std::size_t count, std::size_t grain, RangeFunction body);
+
+  // Joins the workers; the next ParallelFor starts them again.
+  void Shutdown();
+
+  // Threads a ParallelFor can use, including the caller.
+  std::size_t GetThreadCount() const { return workers_.size() + 1; }
+
+private:
+  ThreadPool() = default;
+  ~ThreadPool() { Shutdown(); }
+
+  void Start();
+  void WorkerLoop(std::uint64_t seen);
+  void RunChunks();
+
+  std::vector<std::thread> workers_;
+  std::mutex submitMutex_; // One ParallelFor at a time
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::uint64_t generation_ = 0; // Bumped per job; workers wait for a change
+  std::size_t running_ = 0;      // Workers still inside the current job
+  bool stopping_ = false;
+
+  // Current job, valid while running_ > 0 or the caller runs chunks.
+  const RangeFunction *body_ = nullptr; // The caller's, on its stack
+  std::size_t count_ = 0;
+  std::size_t grain_ = 1;
+  std::atomic<std::size_t> next_{0};
+};
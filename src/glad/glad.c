@@ -19,8 +19,12 @@ PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = NULL;
 PFNGLDELETEPROGRAMPROC glDeleteProgram = NULL;
 PFNGLUSEPROGRAMPROC glUseProgram = NULL;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = NULL;
+PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform = NULL;
 PFNGLUNIFORM1IPROC glUniform1i = NULL;
 PFNGLUNIFORM1FPROC glUniform1f = NULL;
+PFNGLUNIFORM1IVPROC glUniform1iv = NULL;
+PFNGLUNIFORM1FVPROC glUniform1fv = NULL;
+PFNGLUNIFORM4FVPROC glUniform4fv = NULL;
 PFNGLUNIFORM2FPROC glUniform2f = NULL;
 PFNGLUNIFORM3FPROC glUniform3f = NULL;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = NULL;
@@ -39,6 +43,24 @@ PFNGLBINDBUFFERPROC glBindBuffer = NULL;
 PFNGLBUFFERDATAPROC glBufferData = NULL;
 PFNGLBUFFERSUBDATAPROC glBufferSubData = NULL;
 PFNGLBINDBUFFERRANGEPROC glBindBufferRange = NULL;
+PFNGLBINDBUFFERBASEPROC glBindBufferBase = NULL;
+PFNGLBUFFERSTORAGEPROC glBufferStorage = NULL;
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange = NULL;
+PFNGLUNMAPBUFFERPROC glUnmapBuffer = NULL;
+
+/* Sync functions */
+PFNGLFENCESYNCPROC glFenceSync = NULL;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync = NULL;
+PFNGLDELETESYNCPROC glDeleteSync = NULL;
+
+/* Query functions */
+PFNGLGETSTRINGIPROC glGetStringi = NULL;
+PFNGLGENQUERIESPROC glGenQueries = NULL;
+PFNGLDELETEQUERIESPROC glDeleteQueries = NULL;
+PFNGLBEGINQUERYPROC glBeginQuery = NULL;
+PFNGLENDQUERYPROC glEndQuery = NULL;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv = NULL;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = NULL;
 
 /* Vertex attrib functions */
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = NULL;
@@ -47,6 +69,26 @@ PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = NULL;
 
 /* Draw functions */
 PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced = NULL;
+PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate = NULL;
+PFNGLBLENDEQUATIONPROC glBlendEquation = NULL;
+PFNGLDRAWELEMENTSBASEVERTEXPROC glDrawElementsBaseVertex = NULL;
+
+/* Program binary functions */
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = NULL;
+
+/* Parallel shader compile functions */
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR = NULL;
+
+/* Compute functions */
+PFNGLDISPATCHCOMPUTEPROC glDispatchCompute = NULL;
+PFNGLMEMORYBARRIERPROC glMemoryBarrier = NULL;
+
+/* Transform feedback functions */
+PFNGLTRANSFORMFEEDBACKVARYINGSPROC glTransformFeedbackVaryings = NULL;
+PFNGLBEGINTRANSFORMFEEDBACKPROC glBeginTransformFeedback = NULL;
+PFNGLENDTRANSFORMFEEDBACKPROC glEndTransformFeedback = NULL;
 
 /* Framebuffer functions */
 PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = NULL;
@@ -111,8 +153,12 @@ int gladLoadGLLoader(GLADloadproc load) {
   glUseProgram = (PFNGLUSEPROGRAMPROC)load("glUseProgram");
   glGetUniformLocation =
       (PFNGLGETUNIFORMLOCATIONPROC)load("glGetUniformLocation");
+  glGetActiveUniform = (PFNGLGETACTIVEUNIFORMPROC)load("glGetActiveUniform");
   glUniform1i = (PFNGLUNIFORM1IPROC)load("glUniform1i");
   glUniform1f = (PFNGLUNIFORM1FPROC)load("glUniform1f");
+  glUniform1iv = (PFNGLUNIFORM1IVPROC)load("glUniform1iv");
+  glUniform1fv = (PFNGLUNIFORM1FVPROC)load("glUniform1fv");
+  glUniform4fv = (PFNGLUNIFORM4FVPROC)load("glUniform4fv");
   glUniform2f = (PFNGLUNIFORM2FPROC)load("glUniform2f");
   glUniform3f = (PFNGLUNIFORM3FPROC)load("glUniform3f");
   glUniformMatrix4fv = (PFNGLUNIFORMMATRIX4FVPROC)load("glUniformMatrix4fv");
@@ -134,6 +180,27 @@ int gladLoadGLLoader(GLADloadproc load) {
   glBufferData = (PFNGLBUFFERDATAPROC)load("glBufferData");
   glBufferSubData = (PFNGLBUFFERSUBDATAPROC)load("glBufferSubData");
   glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC)load("glBindBufferRange");
+  glBindBufferBase = (PFNGLBINDBUFFERBASEPROC)load("glBindBufferBase");
+  /* GL 4.4 / ARB_buffer_storage, NULL on older drivers */
+  glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+  glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)load("glMapBufferRange");
+  glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)load("glUnmapBuffer");
+
+  /* Sync functions */
+  glFenceSync = (PFNGLFENCESYNCPROC)load("glFenceSync");
+  glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)load("glClientWaitSync");
+  glDeleteSync = (PFNGLDELETESYNCPROC)load("glDeleteSync");
+
+  /* Query functions */
+  glGetStringi = (PFNGLGETSTRINGIPROC)load("glGetStringi");
+  glGenQueries = (PFNGLGENQUERIESPROC)load("glGenQueries");
+  glDeleteQueries = (PFNGLDELETEQUERIESPROC)load("glDeleteQueries");
+  glBeginQuery = (PFNGLBEGINQUERYPROC)load("glBeginQuery");
+  glEndQuery = (PFNGLENDQUERYPROC)load("glEndQuery");
+  glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)load("glGetQueryObjectiv");
+  /* GL 3.3 / ARB_timer_query */
+  glGetQueryObjectui64v =
+      (PFNGLGETQUERYOBJECTUI64VPROC)load("glGetQueryObjectui64v");
 
   /* Vertex attrib functions */
   glEnableVertexAttribArray =
@@ -146,6 +213,37 @@ int gladLoadGLLoader(GLADloadproc load) {
   /* Draw functions */
   glDrawArraysInstanced =
       (PFNGLDRAWARRAYSINSTANCEDPROC)load("glDrawArraysInstanced");
+  glBlendFuncSeparate =
+      (PFNGLBLENDFUNCSEPARATEPROC)load("glBlendFuncSeparate");
+  glBlendEquation = (PFNGLBLENDEQUATIONPROC)load("glBlendEquation");
+  glDrawElementsBaseVertex =
+      (PFNGLDRAWELEMENTSBASEVERTEXPROC)load("glDrawElementsBaseVertex");
+
+  /* Program binary functions (GL 4.1 / ARB_get_program_binary) */
+  glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+  glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+  glProgramParameteri =
+      (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+
+  /* Parallel shader compile (KHR or ARB extension, NULL if absent) */
+  glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load(
+      "glMaxShaderCompilerThreadsKHR");
+  if (!glMaxShaderCompilerThreadsKHR) {
+    glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load(
+        "glMaxShaderCompilerThreadsARB");
+  }
+
+  /* Compute functions (GL 4.3+, NULL on older drivers) */
+  glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC)load("glDispatchCompute");
+  glMemoryBarrier = (PFNGLMEMORYBARRIERPROC)load("glMemoryBarrier");
+
+  /* Transform feedback functions */
+  glTransformFeedbackVaryings =
+      (PFNGLTRANSFORMFEEDBACKVARYINGSPROC)load("glTransformFeedbackVaryings");
+  glBeginTransformFeedback =
+      (PFNGLBEGINTRANSFORMFEEDBACKPROC)load("glBeginTransformFeedback");
+  glEndTransformFeedback =
+      (PFNGLENDTRANSFORMFEEDBACKPROC)load("glEndTransformFeedback");
 
   /* Framebuffer functions */
   glGenFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)load("glGenFramebuffers");
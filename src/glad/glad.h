@@ -42,6 +42,8 @@ typedef void GLvoid;
 typedef char GLchar;
 typedef ptrdiff_t GLsizeiptr;
 typedef ptrdiff_t GLintptr;
+typedef unsigned long long GLuint64;
+typedef struct __GLsync *GLsync;
 
 /* ------------------------------------------------------------------------- */
 /* OpenGL constants                                                          */
@@ -55,6 +57,7 @@ typedef ptrdiff_t GLintptr;
 #define GL_FLOAT 0x1406
 #define GL_UNSIGNED_BYTE 0x1401
 #define GL_UNSIGNED_INT 0x1405
+#define GL_HALF_FLOAT 0x140B
 
 /* Draw modes */
 #define GL_POINTS 0x0000
@@ -73,6 +76,7 @@ typedef ptrdiff_t GLintptr;
 #define GL_TEXTURE_WRAP_T 0x2803
 #define GL_LINEAR 0x2601
 #define GL_NEAREST 0x2600
+#define GL_REPEAT 0x2901
 
 /* Basic texture formats */
 #define GL_RGB 0x1907
@@ -83,6 +87,8 @@ typedef ptrdiff_t GLintptr;
 #define GL_SRC_ALPHA 0x0302
 #define GL_ONE 0x0001
 #define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_FUNC_ADD 0x8006
+#define GL_MAX 0x8008
 
 /* Depth testing */
 #define GL_DEPTH_TEST 0x0B71
@@ -91,25 +97,57 @@ typedef ptrdiff_t GLintptr;
 /* Shader types */
 #define GL_VERTEX_SHADER 0x8B31
 #define GL_FRAGMENT_SHADER 0x8B30
+#define GL_COMPUTE_SHADER 0x91B9
 #define GL_COMPILE_STATUS 0x8B81
 #define GL_LINK_STATUS 0x8B82
 #define GL_INFO_LOG_LENGTH 0x8B84
+#define GL_ACTIVE_UNIFORMS 0x8B86
+#define GL_ACTIVE_UNIFORM_MAX_LENGTH 0x8B87
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
 #define GL_INVALID_INDEX 0xFFFFFFFFu
 
 /* Buffer objects */
 #define GL_ARRAY_BUFFER 0x8892
 #define GL_ELEMENT_ARRAY_BUFFER 0x8893
 #define GL_UNIFORM_BUFFER 0x8A11
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_TRANSFORM_FEEDBACK_BUFFER 0x8C8E
 #define GL_STATIC_DRAW 0x88E4
 #define GL_DYNAMIC_DRAW 0x88E8
+#define GL_DYNAMIC_COPY 0x88EA
+#define GL_STREAM_DRAW 0x88E0
+
+/* Buffer mapping and immutable storage */
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+
+/* Sync objects */
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
 
 /* Texture formats */
 #define GL_RED 0x1903
 #define GL_R8 0x8229
+#define GL_RG 0x8227
+#define GL_RG32F 0x8230
 #define GL_RGBA8 0x8058
 #define GL_SRGB8 0x8C41
 #define GL_SRGB8_ALPHA8 0x8C43
 #define GL_RGBA16F 0x881A
+#define GL_R11F_G11F_B10F 0x8C3A
 #define GL_CLAMP_TO_EDGE 0x812F
 #define GL_TEXTURE_WRAP_R 0x8072
 
@@ -146,6 +184,18 @@ typedef ptrdiff_t GLintptr;
 /* Version query */
 #define GL_MAJOR_VERSION 0x821B
 #define GL_MINOR_VERSION 0x821C
+#define GL_NUM_EXTENSIONS 0x821D
+
+/* Timer queries */
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+
+/* String queries */
+#define GL_VENDOR 0x1F00
+#define GL_RENDERER 0x1F01
+#define GL_VERSION 0x1F02
+#define GL_EXTENSIONS 0x1F03
 
 /* Point sprites */
 #define GL_PROGRAM_POINT_SIZE 0x8642
@@ -153,6 +203,17 @@ typedef ptrdiff_t GLintptr;
 /* Depth function */
 #define GL_LEQUAL 0x0203
 
+/* Transform feedback */
+#define GL_INTERLEAVED_ATTRIBS 0x8C8C
+#define GL_RASTERIZER_DISCARD 0x8C89
+
+/* Memory barriers */
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#define GL_FRAMEBUFFER_BARRIER_BIT 0x00000400
+
 /* ------------------------------------------------------------------------- */
 /* OpenGL 1.1 function typedefs (from opengl32.dll)                          */
 /* ------------------------------------------------------------------------- */
@@ -180,6 +241,11 @@ typedef void(APIENTRY *PFNGLTEXIMAGE2DPROC)(GLenum target, GLint level,
 typedef void(APIENTRY *PFNGLTEXPARAMETERIPROC)(GLenum target, GLenum pname,
                                                GLint param);
 typedef void(APIENTRY *PFNGLBLENDFUNCPROC)(GLenum sfactor, GLenum dfactor);
+typedef void(APIENTRY *PFNGLBLENDFUNCSEPARATEPROC)(GLenum sfactorRGB,
+                                                  GLenum dfactorRGB,
+                                                  GLenum sfactorAlpha,
+                                                  GLenum dfactorAlpha);
+typedef void(APIENTRY *PFNGLBLENDEQUATIONPROC)(GLenum mode);
 typedef void(APIENTRY *PFNGLDEPTHMASKPROC)(GLboolean flag);
 typedef void(APIENTRY *PFNGLDEPTHFUNCPROC)(GLenum func);
 typedef void(APIENTRY *PFNGLGETINTEGERVPROC)(GLenum pname, GLint *data);
@@ -214,8 +280,18 @@ typedef void(APIENTRY *PFNGLDELETEPROGRAMPROC)(GLuint program);
 typedef void(APIENTRY *PFNGLUSEPROGRAMPROC)(GLuint program);
 typedef GLint(APIENTRY *PFNGLGETUNIFORMLOCATIONPROC)(GLuint program,
                                                      const GLchar *name);
+typedef void(APIENTRY *PFNGLGETACTIVEUNIFORMPROC)(GLuint program, GLuint index,
+                                                  GLsizei bufSize,
+                                                  GLsizei *length, GLint *size,
+                                                  GLenum *type, GLchar *name);
 typedef void(APIENTRY *PFNGLUNIFORM1IPROC)(GLint location, GLint v0);
 typedef void(APIENTRY *PFNGLUNIFORM1FPROC)(GLint location, GLfloat v0);
+typedef void(APIENTRY *PFNGLUNIFORM1IVPROC)(GLint location, GLsizei count,
+                                           const GLint *value);
+typedef void(APIENTRY *PFNGLUNIFORM1FVPROC)(GLint location, GLsizei count,
+                                           const GLfloat *value);
+typedef void(APIENTRY *PFNGLUNIFORM4FVPROC)(GLint location, GLsizei count,
+                                           const GLfloat *value);
 typedef void(APIENTRY *PFNGLUNIFORM2FPROC)(GLint location, GLfloat v0,
                                            GLfloat v1);
 typedef void(APIENTRY *PFNGLUNIFORM3FPROC)(GLint location, GLfloat v0,
@@ -247,6 +323,36 @@ typedef void(APIENTRY *PFNGLBUFFERSUBDATAPROC)(GLenum target, GLintptr offset,
 typedef void(APIENTRY *PFNGLBINDBUFFERRANGEPROC)(GLenum target, GLuint index,
                                                  GLuint buffer, GLintptr offset,
                                                  GLsizeiptr size);
+typedef void(APIENTRY *PFNGLBINDBUFFERBASEPROC)(GLenum target, GLuint index,
+                                                GLuint buffer);
+typedef void(APIENTRY *PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size,
+                                               const void *data,
+                                               GLbitfield flags);
+typedef void *(APIENTRY *PFNGLMAPBUFFERRANGEPROC)(GLenum target,
+                                                  GLintptr offset,
+                                                  GLsizeiptr length,
+                                                  GLbitfield access);
+typedef GLboolean(APIENTRY *PFNGLUNMAPBUFFERPROC)(GLenum target);
+
+/* Sync functions */
+typedef GLsync(APIENTRY *PFNGLFENCESYNCPROC)(GLenum condition,
+                                             GLbitfield flags);
+typedef GLenum(APIENTRY *PFNGLCLIENTWAITSYNCPROC)(GLsync sync,
+                                                  GLbitfield flags,
+                                                  GLuint64 timeout);
+typedef void(APIENTRY *PFNGLDELETESYNCPROC)(GLsync sync);
+
+/* Query functions */
+typedef const GLubyte *(APIENTRY *PFNGLGETSTRINGIPROC)(GLenum name,
+                                                       GLuint index);
+typedef void(APIENTRY *PFNGLGENQUERIESPROC)(GLsizei n, GLuint *ids);
+typedef void(APIENTRY *PFNGLDELETEQUERIESPROC)(GLsizei n, const GLuint *ids);
+typedef void(APIENTRY *PFNGLBEGINQUERYPROC)(GLenum target, GLuint id);
+typedef void(APIENTRY *PFNGLENDQUERYPROC)(GLenum target);
+typedef void(APIENTRY *PFNGLGETQUERYOBJECTIVPROC)(GLuint id, GLenum pname,
+                                                  GLint *params);
+typedef void(APIENTRY *PFNGLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname,
+                                                     GLuint64 *params);
 
 /* Vertex attrib functions */
 typedef void(APIENTRY *PFNGLENABLEVERTEXATTRIBARRAYPROC)(GLuint index);
@@ -262,6 +368,40 @@ typedef void(APIENTRY *PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index,
 typedef void(APIENTRY *PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum mode, GLint first,
                                                      GLsizei count,
                                                      GLsizei instancecount);
+typedef void(APIENTRY *PFNGLDRAWELEMENTSBASEVERTEXPROC)(GLenum mode,
+                                                        GLsizei count,
+                                                        GLenum type,
+                                                        const void *indices,
+                                                        GLint basevertex);
+
+/* Program binary functions */
+typedef void(APIENTRY *PFNGLGETPROGRAMBINARYPROC)(GLuint program,
+                                                  GLsizei bufSize,
+                                                  GLsizei *length,
+                                                  GLenum *binaryFormat,
+                                                  void *binary);
+typedef void(APIENTRY *PFNGLPROGRAMBINARYPROC)(GLuint program,
+                                               GLenum binaryFormat,
+                                               const void *binary,
+                                               GLsizei length);
+typedef void(APIENTRY *PFNGLPROGRAMPARAMETERIPROC)(GLuint program,
+                                                   GLenum pname, GLint value);
+
+/* Parallel shader compile functions */
+typedef void(APIENTRY *PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+/* Compute functions */
+typedef void(APIENTRY *PFNGLDISPATCHCOMPUTEPROC)(GLuint num_groups_x,
+                                                 GLuint num_groups_y,
+                                                 GLuint num_groups_z);
+typedef void(APIENTRY *PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
+
+/* Transform feedback functions */
+typedef void(APIENTRY *PFNGLTRANSFORMFEEDBACKVARYINGSPROC)(
+    GLuint program, GLsizei count, const GLchar *const *varyings,
+    GLenum bufferMode);
+typedef void(APIENTRY *PFNGLBEGINTRANSFORMFEEDBACKPROC)(GLenum primitiveMode);
+typedef void(APIENTRY *PFNGLENDTRANSFORMFEEDBACKPROC)(void);
 
 /* Framebuffer functions */
 typedef void(APIENTRY *PFNGLGENFRAMEBUFFERSPROC)(GLsizei n,
@@ -322,6 +462,11 @@ WINGDIAPI void APIENTRY glTexImage2D(GLenum target, GLint level,
                                      GLsizei height, GLint border,
                                      GLenum format, GLenum type,
                                      const void *pixels);
+WINGDIAPI void APIENTRY glTexSubImage2D(GLenum target, GLint level,
+                                        GLint xoffset, GLint yoffset,
+                                        GLsizei width, GLsizei height,
+                                        GLenum format, GLenum type,
+                                        const void *pixels);
 WINGDIAPI void APIENTRY glTexParameteri(GLenum target, GLenum pname,
                                         GLint param);
 WINGDIAPI void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor);
@@ -329,6 +474,7 @@ WINGDIAPI void APIENTRY glDepthMask(GLboolean flag);
 WINGDIAPI void APIENTRY glDepthFunc(GLenum func);
 WINGDIAPI void APIENTRY glGetIntegerv(GLenum pname, GLint *data);
 WINGDIAPI GLenum APIENTRY glGetError(void);
+WINGDIAPI const GLubyte *APIENTRY glGetString(GLenum name);
 
 /* ------------------------------------------------------------------------- */
 /* OpenGL extension function declarations                                    */
@@ -349,8 +495,12 @@ extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
 extern PFNGLDELETEPROGRAMPROC glDeleteProgram;
 extern PFNGLUSEPROGRAMPROC glUseProgram;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
+extern PFNGLGETACTIVEUNIFORMPROC glGetActiveUniform;
 extern PFNGLUNIFORM1IPROC glUniform1i;
 extern PFNGLUNIFORM1FPROC glUniform1f;
+extern PFNGLUNIFORM1IVPROC glUniform1iv;
+extern PFNGLUNIFORM1FVPROC glUniform1fv;
+extern PFNGLUNIFORM4FVPROC glUniform4fv;
 extern PFNGLUNIFORM2FPROC glUniform2f;
 extern PFNGLUNIFORM3FPROC glUniform3f;
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
@@ -369,6 +519,24 @@ extern PFNGLBINDBUFFERPROC glBindBuffer;
 extern PFNGLBUFFERDATAPROC glBufferData;
 extern PFNGLBUFFERSUBDATAPROC glBufferSubData;
 extern PFNGLBINDBUFFERRANGEPROC glBindBufferRange;
+extern PFNGLBINDBUFFERBASEPROC glBindBufferBase;
+extern PFNGLBUFFERSTORAGEPROC glBufferStorage;
+extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+
+/* Sync functions */
+extern PFNGLFENCESYNCPROC glFenceSync;
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+extern PFNGLDELETESYNCPROC glDeleteSync;
+
+/* Query functions */
+extern PFNGLGETSTRINGIPROC glGetStringi;
+extern PFNGLGENQUERIESPROC glGenQueries;
+extern PFNGLDELETEQUERIESPROC glDeleteQueries;
+extern PFNGLBEGINQUERYPROC glBeginQuery;
+extern PFNGLENDQUERYPROC glEndQuery;
+extern PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
 
 /* Vertex attrib functions */
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
@@ -377,6 +545,26 @@ extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
 
 /* Draw functions */
 extern PFNGLDRAWARRAYSINSTANCEDPROC glDrawArraysInstanced;
+extern PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparate;
+extern PFNGLBLENDEQUATIONPROC glBlendEquation;
+extern PFNGLDRAWELEMENTSBASEVERTEXPROC glDrawElementsBaseVertex;
+
+/* Program binary functions */
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
+/* Parallel shader compile functions */
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR;
+
+/* Compute functions */
+extern PFNGLDISPATCHCOMPUTEPROC glDispatchCompute;
+extern PFNGLMEMORYBARRIERPROC glMemoryBarrier;
+
+/* Transform feedback functions */
+extern PFNGLTRANSFORMFEEDBACKVARYINGSPROC glTransformFeedbackVaryings;
+extern PFNGLBEGINTRANSFORMFEEDBACKPROC glBeginTransformFeedback;
+extern PFNGLENDTRANSFORMFEEDBACKPROC glEndTransformFeedback;
 
 /* Framebuffer functions */
 extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
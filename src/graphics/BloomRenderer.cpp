@@ -0,0 +1,184 @@
+#include "BloomRenderer.h"
+
+#include <algorithm>
+
+#include "GLStateCache.h"
+
+namespace {
+const char *const kVertexPath = "assets/shaders/fullscreen.vert";
+const char *const kDownsamplePath = "assets/shaders/bloom_downsample.frag";
+const char *const kUpsamplePath = "assets/shaders/bloom_upsample.frag";
+
+// Soft knee as a fraction of the threshold.
+constexpr float kKneeRatio = 0.5f;
+} // namespace
+
+bool BloomRenderer::Initialize() {
+  prefilterShader_ = Shader::CreateAsync(kVertexPath, kDownsamplePath,
+                                         "#define BLOOM_PREFILTER 1\n");
+  downsampleShader_ = Shader::CreateAsync(kVertexPath, kDownsamplePath);
+  upsampleShader_ = Shader::CreateAsync(kVertexPath, kUpsamplePath);
+  applyShader_ = Shader::CreateAsync(kVertexPath, kUpsamplePath,
+                                     "#define BLOOM_APPLY 1\n");
+  ready_ = false;
+
+  quad_ = CreateFullscreenQuadMesh();
+  return true;
+}
+
+void BloomRenderer::Cleanup() {
+  DestroyMesh(quad_);
+  prefilterShader_.reset();
+  downsampleShader_.reset();
+  upsampleShader_.reset();
+  applyShader_.reset();
+  ready_ = false;
+}
+
+void BloomRenderer::AddPass(FrameGraph &graph, FrameGraphResource target,
+                            int width, int height,
+                            const PostProcessConfig &fx) {
+  Params params;
+  params.threshold = fx.bloomThreshold;
+  params.knee = std::max(fx.bloomThreshold * kKneeRatio, 1e-3f);
+  params.intensity = fx.bloomIntensity;
+  // bloomRadius was the blur radius in pixels of the old separable blur;
+  // the default of 5 maps to one texel of tap spacing.
+  params.filterRadius = std::clamp(fx.bloomRadius * 0.2f, 0.25f, 3.0f);
+  AddBloomPass(graph, target, width, height, params);
+}
+
+FrameGraphResource BloomRenderer::AddChainPass(FrameGraph &graph,
+                                               FrameGraphResource source,
+                                               int width, int height,
+                                               float threshold) {
+  Params params;
+  params.threshold = threshold;
+  params.knee = std::max(threshold * kKneeRatio, 1e-3f);
+  params.apply = false;
+  return AddBloomPass(graph, source, width, height, params);
+}
+
+FrameGraphResource BloomRenderer::AddBloomPass(FrameGraph &graph,
+                                               FrameGraphResource source,
+                                               int width, int height,
+                                               const Params &params) {
+  std::array<FrameGraphResource, kMaxLevels> levels;
+  levels.fill(kInvalidFrameGraphResource);
+  int levelCount = 0;
+  int levelWidth = width / 2;
+  int levelHeight = height / 2;
+  while (levelCount < kMaxLevels && levelWidth >= kMinLevelSize &&
+         levelHeight >= kMinLevelSize) {
+    levels[levelCount++] =
+        graph.Create("BloomLevel", {levelWidth, levelHeight, GL_RGBA16F, 0});
+    levelWidth /= 2;
+    levelHeight /= 2;
+  }
+  if (levelCount == 0) {
+    return kInvalidFrameGraphResource; // Too small to bloom
+  }
+
+  graph.AddPass(
+      "Bloom",
+      [&](FrameGraph::Builder &builder) {
+        builder.Read(source);
+        for (int i = 0; i < levelCount; ++i) {
+          builder.Write(levels[i]);
+        }
+        if (params.apply) {
+          builder.Write(source);
+        }
+      },
+      [this, source, levels, levelCount, params](const FrameGraph &g) {
+        Execute(g, source, levels, levelCount, params);
+      });
+  return levels[0];
+}
+
+// Collects the four programs once all their builds have finished.
+bool BloomRenderer::IsReady() {
+  if (ready_) {
+    return true;
+  }
+  Shader *shaders[] = {prefilterShader_.get(), downsampleShader_.get(),
+                       upsampleShader_.get(), applyShader_.get()};
+  for (Shader *shader : shaders) {
+    if (!shader || !shader->Poll() || !shader->IsValid()) {
+      return false;
+    }
+  }
+  // The source is always sampled from unit 0.
+  for (Shader *shader : shaders) {
+    shader->Use();
+    shader->SetInt("uSource", 0);
+  }
+  ready_ = true;
+  return true;
+}
+
+void BloomRenderer::Execute(
+    const FrameGraph &graph, FrameGraphResource source,
+    const std::array<FrameGraphResource, kMaxLevels> &levels, int levelCount,
+    const Params &params) {
+  const RenderTarget &src = *graph.GetTarget(source);
+  const RenderTarget *chain[kMaxLevels] = {};
+  for (int i = 0; i < levelCount; ++i) {
+    chain[i] = graph.GetTarget(levels[i]);
+  }
+
+  GLStateCache &gl = GLStateCache::Get();
+  if (!IsReady()) {
+    // Whoever reads the half-size level must not see stale contents.
+    if (!params.apply) {
+      gl.BindFramebuffer(chain[0]->fbo);
+      glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+      glClear(GL_COLOR_BUFFER_BIT);
+    }
+    return;
+  }
+  gl.SetDepthTest(false);
+
+  // Down the chain; each level is fully overwritten.
+  gl.SetBlend(false);
+  prefilterShader_->Use();
+  prefilterShader_->SetFloat("uThreshold", params.threshold);
+  prefilterShader_->SetFloat("uKnee", params.knee);
+  Draw(*prefilterShader_, src, *chain[0]);
+  for (int i = 1; i < levelCount; ++i) {
+    Draw(*downsampleShader_, *chain[i - 1], *chain[i]);
+  }
+
+  // Back up, accumulating each level onto the next larger one.
+  gl.SetBlend(true);
+  gl.BlendFunc(GL_ONE, GL_ONE);
+  upsampleShader_->Use();
+  upsampleShader_->SetFloat("uFilterRadius", params.filterRadius);
+  for (int i = levelCount - 1; i > 0; --i) {
+    Draw(*upsampleShader_, *chain[i], *chain[i - 1]);
+  }
+  if (!params.apply) {
+    return;
+  }
+
+  // Color is added; alpha is composited over so the glow also covers the
+  // transparent parts of the source.
+  gl.BlendFuncSeparate(GL_ONE, GL_ONE, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  applyShader_->Use();
+  applyShader_->SetFloat("uFilterRadius", params.filterRadius);
+  applyShader_->SetFloat("uIntensity", params.intensity);
+  Draw(*applyShader_, *chain[0], src);
+}
+
+void BloomRenderer::Draw(const Shader &shader, const RenderTarget &source,
+                         const RenderTarget &dest) {
+  GLStateCache &gl = GLStateCache::Get();
+  gl.BindFramebuffer(dest.fbo);
+  gl.Viewport(0, 0, dest.desc.width, dest.desc.height);
+  shader.Use();
+  shader.SetVec2("uSourceTexelSize",
+                 1.0f / static_cast<float>(source.desc.width),
+                 1.0f / static_cast<float>(source.desc.height));
+  gl.BindTexture(0, GL_TEXTURE_2D, source.colorTex);
+  DrawMesh(quad_);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "FrameGraph.h"
+#include "Mesh.h"
+#include "PostProcessConfig.h"
+#include "Shader.h"
+
+// Per-layer bloom through a mip chain (dual filter):
+//  - prefilter: soft-knee threshold of the layer into a half-size level,
+//  - downsample: each level into the next, half the size again, down to
+//    kMaxLevels levels or kMinLevelSize pixels,
+//  - upsample: each level tent-filtered and added onto the next larger one,
+//  - apply: the half-size level added back onto the layer target.
+// Each pass does a handful of taps whatever the radius; the radius only
+// scales the upsample tap spacing. Replaces a full-resolution separable
+// blur, which cost taps per pixel in proportion to the radius.
+//
+// The chain levels are frame graph transients that live for the one bloom
+// pass, so every bloomed layer of the same size reuses the same pooled
+// chain. AddChainPass() skips the apply step and hands the half-size level
+// to a later pass instead (the final output pass adds it while tonemapping).
+class BloomRenderer {
+public:
+  static constexpr int kMaxLevels = 6;
+  static constexpr int kMinLevelSize = 4;
+
+  BloomRenderer() = default;
+  ~BloomRenderer() { Cleanup(); }
+
+  BloomRenderer(const BloomRenderer &) = delete;
+  BloomRenderer &operator=(const BloomRenderer &) = delete;
+
+  // Issues the shader builds; until they finish, AddPass() passes do
+  // nothing.
+  bool Initialize();
+  void Cleanup();
+
+  // Adds a pass that blooms `target` (width x height) in place with the
+  // bloom settings of `fx`. Passes declared later that read `target` see
+  // the bloomed result.
+  void AddPass(FrameGraph &graph, FrameGraphResource target, int width,
+               int height, const PostProcessConfig &fx);
+  // Adds a pass that builds the bloom of `source` without touching it and
+  // returns the half-size level holding the result, or
+  // kInvalidFrameGraphResource if `source` is too small. The level is black
+  // while the shaders are still building.
+  FrameGraphResource AddChainPass(FrameGraph &graph, FrameGraphResource source,
+                                  int width, int height, float threshold);
+
+private:
+  struct Params {
+    float threshold = 0.8f;
+    float knee = 0.4f;
+    float intensity = 1.0f;
+    float filterRadius = 1.0f;
+    bool apply = true; // Add the result back onto the source
+  };
+
+  FrameGraphResource AddBloomPass(FrameGraph &graph, FrameGraphResource source,
+                                  int width, int height, const Params &params);
+  bool IsReady();
+  void Execute(const FrameGraph &graph, FrameGraphResource source,
+               const std::array<FrameGraphResource, kMaxLevels> &levels,
+               int levelCount, const Params &params);
+  void Draw(const Shader &shader, const RenderTarget &source,
+            const RenderTarget &dest);
+
+  std::unique_ptr<Shader> prefilterShader_;
+  std::unique_ptr<Shader> downsampleShader_;
+  std::unique_ptr<Shader> upsampleShader_;
+  std::unique_ptr<Shader> applyShader_;
+  bool ready_ = false;
+  Mesh quad_{};
+};
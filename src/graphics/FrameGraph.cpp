@@ -0,0 +1,286 @@
+#include "FrameGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+FrameGraphResource FrameGraph::Builder::Create(const char *name,
+                                               const RenderTargetDesc &desc) {
+  return graph_.Create(name, desc);
+}
+
+void FrameGraph::Builder::Read(FrameGraphResource resource) {
+  if (resource != kInvalidFrameGraphResource) {
+    graph_.passes_[pass_].reads.push_back(resource);
+  }
+}
+
+void FrameGraph::Builder::Write(FrameGraphResource resource) {
+  if (resource != kInvalidFrameGraphResource) {
+    graph_.passes_[pass_].writes.push_back(resource);
+  }
+}
+
+void FrameGraph::Builder::WriteStorage(FrameGraphResource resource) {
+  if (resource != kInvalidFrameGraphResource) {
+    graph_.passes_[pass_].writes.push_back(resource);
+    graph_.passes_[pass_].storageWrites.push_back(resource);
+  }
+}
+
+FrameGraphResource FrameGraph::Create(const char *name,
+                                      const RenderTargetDesc &desc) {
+  Resource resource;
+  resource.name = name;
+  resource.desc = desc;
+  resources_.push_back(std::move(resource));
+  return static_cast<FrameGraphResource>(resources_.size() - 1);
+}
+
+FrameGraphResource FrameGraph::Import(const char *name, RenderTarget *target,
+                                      bool retained) {
+  if (!target) {
+    return kInvalidFrameGraphResource;
+  }
+  Resource resource;
+  resource.name = name;
+  resource.desc = target->desc;
+  resource.target = target;
+  resource.imported = true;
+  resource.retained = retained;
+  resources_.push_back(std::move(resource));
+  return static_cast<FrameGraphResource>(resources_.size() - 1);
+}
+
+FrameGraphResource FrameGraph::ImportBackbuffer(int width, int height) {
+  Resource resource;
+  resource.name = "Backbuffer";
+  resource.desc = {width, height, GL_RGBA8, GL_DEPTH_COMPONENT24};
+  resource.backbuffer.desc = resource.desc;
+  resource.isBackbuffer = true;
+  resource.imported = true;
+  resource.retained = true;
+  resources_.push_back(std::move(resource));
+  return static_cast<FrameGraphResource>(resources_.size() - 1);
+}
+
+void FrameGraph::AddPass(const char *name, const SetupFn &setup,
+                         ExecuteFn execute) {
+  Pass pass;
+  pass.name = name;
+  pass.execute = std::move(execute);
+  passes_.push_back(std::move(pass));
+  Builder builder(*this, static_cast<int>(passes_.size() - 1));
+  setup(builder);
+}
+
+bool FrameGraph::Writes(const Pass &pass, FrameGraphResource resource) const {
+  return std::find(pass.writes.begin(), pass.writes.end(), resource) !=
+         pass.writes.end();
+}
+
+void FrameGraph::Compile() {
+  const int passCount = static_cast<int>(passes_.size());
+
+  // Each write makes a new version of a resource, and a read sees the
+  // version left by the most recent earlier writer. Dependencies therefore
+  // only ever point back to earlier passes, so a read-modify-write chain on
+  // one target (draw, trails, bloom, composite) orders the way it was
+  // declared instead of forming a cycle.
+
+  // Cull: walk backwards from the retained resources, keeping every pass
+  // that writes something a later kept pass (or the outside world) needs.
+  std::vector<bool> needed(resources_.size(), false);
+  for (std::size_t r = 0; r < resources_.size(); ++r) {
+    needed[r] = resources_[r].retained;
+  }
+  for (int p = passCount - 1; p >= 0; --p) {
+    Pass &pass = passes_[p];
+    for (FrameGraphResource w : pass.writes) {
+      pass.alive = pass.alive || needed[w];
+    }
+    if (pass.alive) {
+      for (FrameGraphResource r : pass.reads) {
+        needed[r] = true;
+      }
+    }
+  }
+
+  // Order: a pass runs after the last earlier writer of each resource it
+  // reads or writes, and after the passes that read the version it
+  // overwrites. Kahn's algorithm, always taking the earliest declared ready
+  // pass.
+  std::vector<std::vector<int>> dependents(passCount);
+  std::vector<int> pending(passCount, 0);
+  auto dependOn = [&](int q, int p) {
+    if (q < 0 || q == p) {
+      return;
+    }
+    std::vector<int> &edges = dependents[q];
+    if (std::find(edges.begin(), edges.end(), p) == edges.end()) {
+      edges.push_back(p);
+      ++pending[p];
+    }
+  };
+  std::vector<int> lastWriter(resources_.size(), -1);
+  std::vector<std::vector<int>> readers(resources_.size());
+  for (int p = 0; p < passCount; ++p) {
+    const Pass &pass = passes_[p];
+    if (!pass.alive) {
+      continue;
+    }
+    for (FrameGraphResource r : pass.reads) {
+      dependOn(lastWriter[r], p);
+    }
+    for (FrameGraphResource w : pass.writes) {
+      dependOn(lastWriter[w], p);
+      for (int reader : readers[w]) {
+        dependOn(reader, p);
+      }
+    }
+    for (FrameGraphResource r : pass.reads) {
+      readers[r].push_back(p);
+    }
+    for (FrameGraphResource w : pass.writes) {
+      lastWriter[w] = p;
+      readers[w].clear();
+    }
+  }
+
+  order_.clear();
+  std::vector<bool> scheduled(passCount, false);
+  for (;;) {
+    int next = -1;
+    for (int p = 0; p < passCount; ++p) {
+      if (passes_[p].alive && !scheduled[p] && pending[p] == 0) {
+        next = p;
+        break;
+      }
+    }
+    if (next < 0) {
+      break;
+    }
+    scheduled[next] = true;
+    order_.push_back(next);
+    for (int d : dependents[next]) {
+      --pending[d];
+    }
+  }
+
+  culledCount_ = 0;
+  std::size_t aliveCount = 0;
+  for (const Pass &pass : passes_) {
+    if (pass.alive) {
+      ++aliveCount;
+    } else {
+      ++culledCount_;
+    }
+  }
+  // Every dependency points at an earlier declared pass, so the sort always
+  // schedules every alive pass.
+  assert(order_.size() == aliveCount);
+#ifndef NDEBUG
+  // Each read must run after the writer whose version it sees.
+  std::vector<int> position(passCount, -1);
+  for (int i = 0; i < static_cast<int>(order_.size()); ++i) {
+    position[order_[i]] = i;
+  }
+  std::fill(lastWriter.begin(), lastWriter.end(), -1);
+  for (int p = 0; p < passCount; ++p) {
+    if (!passes_[p].alive) {
+      continue;
+    }
+    for (FrameGraphResource r : passes_[p].reads) {
+      assert(lastWriter[r] < 0 || position[lastWriter[r]] < position[p]);
+    }
+    for (FrameGraphResource w : passes_[p].writes) {
+      lastWriter[w] = p;
+    }
+  }
+#endif
+
+  // Lifetimes, in execution order
+  for (int i = 0; i < static_cast<int>(order_.size()); ++i) {
+    const Pass &pass = passes_[order_[i]];
+    auto touch = [&](FrameGraphResource r) {
+      Resource &resource = resources_[r];
+      if (resource.firstUse < 0) {
+        resource.firstUse = i;
+      }
+      resource.lastUse = i;
+    };
+    for (FrameGraphResource r : pass.reads) {
+      touch(r);
+    }
+    for (FrameGraphResource w : pass.writes) {
+      touch(w);
+    }
+  }
+}
+
+void FrameGraph::Execute() {
+  RenderTargetPool &pool = RenderTargetPool::Get();
+  for (int i = 0; i < static_cast<int>(order_.size()); ++i) {
+    Pass &pass = passes_[order_[i]];
+
+    GLbitfield barriers = 0;
+    for (FrameGraphResource r : pass.reads) {
+      if (resources_[r].storageWritten) {
+        barriers |= GL_TEXTURE_FETCH_BARRIER_BIT |
+                    GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                    GL_FRAMEBUFFER_BARRIER_BIT;
+        resources_[r].storageWritten = false;
+      }
+    }
+    if (barriers) {
+      glMemoryBarrier(barriers);
+    }
+
+    for (Resource &resource : resources_) {
+      if (!resource.imported && resource.firstUse == i) {
+        resource.target = pool.Acquire(resource.desc);
+      }
+    }
+
+    // A pass whose transient could not be allocated is skipped rather than
+    // handed a null target.
+    bool resolved = true;
+    for (FrameGraphResource r : pass.reads) {
+      resolved = resolved && GetTarget(r);
+    }
+    for (FrameGraphResource w : pass.writes) {
+      resolved = resolved && GetTarget(w);
+    }
+    if (resolved) {
+      pass.execute(*this);
+    }
+
+    for (FrameGraphResource w : pass.writes) {
+      resources_[w].storageWritten =
+          std::find(pass.storageWrites.begin(), pass.storageWrites.end(),
+                    w) != pass.storageWrites.end();
+    }
+    for (Resource &resource : resources_) {
+      if (!resource.imported && resource.lastUse == i) {
+        pool.Release(resource.target);
+        resource.target = nullptr;
+      }
+    }
+  }
+}
+
+void FrameGraph::Reset() {
+  resources_.clear();
+  passes_.clear();
+  order_.clear();
+  culledCount_ = 0;
+}
+
+const RenderTarget *FrameGraph::GetTarget(FrameGraphResource resource) const {
+  if (resource < 0 || resource >= static_cast<FrameGraphResource>(
+                                      resources_.size())) {
+    return nullptr;
+  }
+  const Resource &r = resources_[resource];
+  return r.isBackbuffer ? &r.backbuffer : r.target;
+}
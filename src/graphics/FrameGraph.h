@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../glad/glad.h"
+#include "RenderTargetPool.h"
+
+// Handle to a resource declared in a FrameGraph. Only valid for the frame
+// it was declared in.
+using FrameGraphResource = int;
+constexpr FrameGraphResource kInvalidFrameGraphResource = -1;
+
+// Per-frame graph of render passes. Each pass declares the resources it
+// reads and writes in a setup callback; Compile() then
+//  - culls passes whose outputs nothing reads (only writes to retained
+//    resources, such as the backbuffer, keep a pass alive on their own),
+//  - orders the survivors so every read comes after the most recent
+//    earlier writer of that resource, and every write after the passes
+//    reading the version it replaces (ties keep declaration order). A pass
+//    may read and write the same target, so a chain such as draw -> trails
+//    -> bloom -> composite on one layer target runs in declaration order,
+//  - works out the lifetime of each transient resource.
+// Execute() acquires transient targets from the RenderTargetPool right
+// before their first use and releases them right after their last, so
+// transients with disjoint lifetimes share memory. It also issues a
+// glMemoryBarrier before a pass that reads a resource last written through
+// image stores (WriteStorage); framebuffer writes need no barrier.
+//
+// The graph is rebuilt every frame: Reset(), declare, Compile(), Execute().
+class FrameGraph {
+public:
+  class Builder {
+  public:
+    // Declares a transient target (see FrameGraph::Create).
+    FrameGraphResource Create(const char *name, const RenderTargetDesc &desc);
+    void Read(FrameGraphResource resource);
+    void Write(FrameGraphResource resource);
+    // Write through image load/store or from compute.
+    void WriteStorage(FrameGraphResource resource);
+
+  private:
+    friend class FrameGraph;
+    Builder(FrameGraph &graph, int pass) : graph_(graph), pass_(pass) {}
+    FrameGraph &graph_;
+    int pass_;
+  };
+
+  using SetupFn = std::function<void(Builder &)>;
+  using ExecuteFn = std::function<void(const FrameGraph &)>;
+
+  // Transient target allocated from the pool for the passes that use it.
+  // Contents are undefined on first use. Builder::Create is the same thing
+  // for a resource only one pass's setup needs to know about.
+  FrameGraphResource Create(const char *name, const RenderTargetDesc &desc);
+  // Targets owned elsewhere (layer targets). A retained resource keeps its
+  // writers alive even if no pass reads it.
+  FrameGraphResource Import(const char *name, RenderTarget *target,
+                            bool retained = false);
+  // The default framebuffer; always retained.
+  FrameGraphResource ImportBackbuffer(int width, int height);
+
+  void AddPass(const char *name, const SetupFn &setup,
+               ExecuteFn execute);
+
+  void Compile();
+  void Execute();
+  // Forgets every pass and resource, keeping the allocations.
+  void Reset();
+
+  // The target behind a resource. Transients are only valid while a pass
+  // that declared them is executing.
+  const RenderTarget *GetTarget(FrameGraphResource resource) const;
+
+  std::size_t GetPassCount() const { return passes_.size(); }
+  std::size_t GetCulledPassCount() const { return culledCount_; }
+
+private:
+  struct Resource {
+    std::string name;
+    RenderTargetDesc desc;
+    RenderTarget *target = nullptr; // Imported, or acquired while live
+    RenderTarget backbuffer;        // fbo 0; used when isBackbuffer
+    bool isBackbuffer = false;
+    bool imported = false;
+    bool retained = false;
+    bool storageWritten = false; // Last writer used image stores
+    int firstUse = -1;           // Indices into order_
+    int lastUse = -1;
+  };
+
+  struct Pass {
+    std::string name;
+    ExecuteFn execute;
+    std::vector<FrameGraphResource> reads;
+    std::vector<FrameGraphResource> writes;
+    std::vector<FrameGraphResource> storageWrites;
+    bool alive = false;
+  };
+
+  bool Writes(const Pass &pass, FrameGraphResource resource) const;
+
+  std::vector<Resource> resources_;
+  std::vector<Pass> passes_;
+  std::vector<int> order_; // Alive passes, in execution order
+  std::size_t culledCount_ = 0;
+};
@@ -0,0 +1,57 @@
+#include "GLCapabilities.h"
+
+namespace {
+std::string GetGLString(GLenum name) {
+  const GLubyte *value = glGetString(name);
+  return value ? reinterpret_cast<const char *>(value) : std::string();
+}
+} // namespace
+
+const GLCapabilities &GLCapabilities::Get() {
+  static const GLCapabilities capabilities;
+  return capabilities;
+}
+
+GLCapabilities::GLCapabilities() {
+  GLint major = 0;
+  GLint minor = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &major);
+  glGetIntegerv(GL_MINOR_VERSION, &minor);
+  major_ = major;
+  minor_ = minor;
+  vendor_ = GetGLString(GL_VENDOR);
+  renderer_ = GetGLString(GL_RENDERER);
+  version_ = GetGLString(GL_VERSION);
+
+  if (glGetStringi) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+      const GLubyte *name = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+      if (name) {
+        extensions_.insert(reinterpret_cast<const char *>(name));
+      }
+    }
+  }
+
+  bufferStorage_ = glBufferStorage && glMapBufferRange && glFenceSync &&
+                   (HasVersion(4, 4) || HasExtension("GL_ARB_buffer_storage"));
+
+  if (glGetProgramBinary && glProgramBinary && glProgramParameteri &&
+      (HasVersion(4, 1) || HasExtension("GL_ARB_get_program_binary"))) {
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    programBinary_ = formats > 0;
+  }
+
+  parallelCompile_ = HasExtension("GL_KHR_parallel_shader_compile") ||
+                     HasExtension("GL_ARB_parallel_shader_compile");
+}
+
+bool GLCapabilities::HasVersion(int major, int minor) const {
+  return major_ > major || (major_ == major && minor_ >= minor);
+}
+
+bool GLCapabilities::HasExtension(const std::string &name) const {
+  return extensions_.count(name) != 0;
+}
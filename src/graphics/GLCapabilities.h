@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+
+#include "../glad/glad.h"
+
+// Version and extension queries for the current context. Read once on first
+// use, so Get() must not be called before the context is current and the
+// loader has run.
+class GLCapabilities {
+public:
+  static const GLCapabilities &Get();
+
+  bool HasVersion(int major, int minor) const;
+  bool HasExtension(const std::string &name) const;
+
+  int GetMajorVersion() const { return major_; }
+  int GetMinorVersion() const { return minor_; }
+
+  // GL_VENDOR / GL_RENDERER / GL_VERSION, empty if the driver returned null.
+  const std::string &GetVendor() const { return vendor_; }
+  const std::string &GetRenderer() const { return renderer_; }
+  const std::string &GetVersionString() const { return version_; }
+
+  // Immutable, persistently mapped buffers (GL 4.4 / ARB_buffer_storage).
+  bool SupportsBufferStorage() const { return bufferStorage_; }
+  // glGetProgramBinary/glProgramBinary with at least one binary format
+  // (GL 4.1 / ARB_get_program_binary).
+  bool SupportsProgramBinary() const { return programBinary_; }
+  // Non-blocking GL_COMPLETION_STATUS_KHR queries
+  // (KHR/ARB_parallel_shader_compile).
+  bool SupportsParallelShaderCompile() const { return parallelCompile_; }
+
+private:
+  GLCapabilities();
+
+  int major_ = 0;
+  int minor_ = 0;
+  bool bufferStorage_ = false;
+  bool programBinary_ = false;
+  bool parallelCompile_ = false;
+  std::string vendor_;
+  std::string renderer_;
+  std::string version_;
+  std::unordered_set<std::string> extensions_;
+};
@@ -0,0 +1,174 @@
+#include "GLStateCache.h"
+
+namespace {
+int TargetSlot(GLenum target) {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return 0;
+  case GL_TEXTURE_CUBE_MAP:
+    return 1;
+  default:
+    return -1;
+  }
+}
+} // namespace
+
+GLStateCache &GLStateCache::Get() {
+  static GLStateCache cache;
+  return cache;
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+  if (Changed(program_ != program)) {
+    glUseProgram(program);
+    program_ = program;
+  }
+}
+
+void GLStateCache::BindVertexArray(GLuint vao) {
+  if (Changed(vao_ != vao)) {
+    glBindVertexArray(vao);
+    vao_ = vao;
+  }
+}
+
+void GLStateCache::BindFramebuffer(GLuint fbo) {
+  if (Changed(fbo_ != fbo)) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    fbo_ = fbo;
+  }
+}
+
+void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+  if (Changed(activeUnit_ != unit)) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    activeUnit_ = unit;
+  }
+
+  const int slot = TargetSlot(target);
+  if (slot < 0 || unit >= static_cast<GLuint>(kMaxTextureUnits)) {
+    Changed(true);
+    glBindTexture(target, texture);
+    return;
+  }
+  GLuint &bound = textures_[slot][unit];
+  if (Changed(bound != texture)) {
+    glBindTexture(target, texture);
+    bound = texture;
+  }
+}
+
+void GLStateCache::SetCapability(GLenum cap, int &current, bool enabled) {
+  const int value = enabled ? 1 : 0;
+  if (Changed(current != value)) {
+    if (enabled) {
+      glEnable(cap);
+    } else {
+      glDisable(cap);
+    }
+    current = value;
+  }
+}
+
+void GLStateCache::SetBlend(bool enabled) {
+  SetCapability(GL_BLEND, blend_, enabled);
+}
+
+void GLStateCache::BlendFunc(GLenum src, GLenum dst) {
+  BlendFuncSeparate(src, dst, src, dst);
+}
+
+void GLStateCache::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB,
+                                     GLenum srcAlpha, GLenum dstAlpha) {
+  if (Changed(blendSrc_ != srcRGB || blendDst_ != dstRGB ||
+              blendSrcAlpha_ != srcAlpha || blendDstAlpha_ != dstAlpha)) {
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    blendSrc_ = srcRGB;
+    blendDst_ = dstRGB;
+    blendSrcAlpha_ = srcAlpha;
+    blendDstAlpha_ = dstAlpha;
+  }
+}
+
+void GLStateCache::BlendEquation(GLenum mode) {
+  if (Changed(blendEquation_ != mode)) {
+    glBlendEquation(mode);
+    blendEquation_ = mode;
+  }
+}
+
+void GLStateCache::SetDepthTest(bool enabled) {
+  SetCapability(GL_DEPTH_TEST, depthTest_, enabled);
+}
+
+void GLStateCache::SetDepthMask(bool enabled) {
+  const int value = enabled ? 1 : 0;
+  if (Changed(depthMask_ != value)) {
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    depthMask_ = value;
+  }
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width,
+                            GLsizei height) {
+  if (Changed(!viewportKnown_ || viewport_[0] != x || viewport_[1] != y ||
+              viewport_[2] != width || viewport_[3] != height)) {
+    glViewport(x, y, width, height);
+    viewport_[0] = x;
+    viewport_[1] = y;
+    viewport_[2] = width;
+    viewport_[3] = height;
+    viewportKnown_ = true;
+  }
+}
+
+void GLStateCache::OnProgramDeleted(GLuint program) {
+  // Deleting the current program leaves it in use until another is bound;
+  // forgetting it makes the next UseProgram reach the driver either way.
+  if (program_ == program) {
+    program_ = kUnknown;
+  }
+}
+
+void GLStateCache::OnVertexArrayDeleted(GLuint vao) {
+  if (vao_ == vao) {
+    vao_ = 0; // Deleting the bound VAO reverts the binding to zero
+  }
+}
+
+void GLStateCache::OnFramebufferDeleted(GLuint fbo) {
+  if (fbo_ == fbo) {
+    fbo_ = 0;
+  }
+}
+
+void GLStateCache::OnTextureDeleted(GLuint texture) {
+  for (auto &unitBindings : textures_) {
+    for (GLuint &bound : unitBindings) {
+      if (bound == texture) {
+        bound = 0;
+      }
+    }
+  }
+}
+
+void GLStateCache::Invalidate() {
+  program_ = kUnknown;
+  vao_ = kUnknown;
+  fbo_ = kUnknown;
+  activeUnit_ = kUnknown;
+  for (auto &unitBindings : textures_) {
+    for (GLuint &bound : unitBindings) {
+      bound = kUnknown;
+    }
+  }
+  blend_ = -1;
+  blendSrc_ = kUnknown;
+  blendDst_ = kUnknown;
+  blendSrcAlpha_ = kUnknown;
+  blendDstAlpha_ = kUnknown;
+  blendEquation_ = kUnknown;
+  depthTest_ = -1;
+  depthMask_ = -1;
+  viewportKnown_ = false;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../glad/glad.h"
+
+// Shadow copy of the GL state the renderer changes most often: program, VAO,
+// framebuffer, 2D/cube textures per unit, blend, depth and viewport. Every
+// setter compares against the shadow copy and only calls into the driver
+// when the value actually changes.
+//
+// This only works if all engine code changes these states through the
+// cache. Code that must bypass it calls Invalidate() afterwards, and
+// deleting a tracked object must be reported through the On*Deleted hooks so
+// that a recycled name is not mistaken for the old, still-bound object.
+//
+// The initial state is "unknown", so the first call of each kind is always
+// issued.
+class GLStateCache {
+public:
+  static constexpr int kMaxTextureUnits = 16;
+
+  struct Stats {
+    std::uint64_t issued = 0;    // Calls forwarded to the driver
+    std::uint64_t redundant = 0; // Calls filtered out
+  };
+
+  static GLStateCache &Get();
+
+  void UseProgram(GLuint program);
+  void BindVertexArray(GLuint vao);
+  // Binds to GL_FRAMEBUFFER (draw and read).
+  void BindFramebuffer(GLuint fbo);
+  // Selects `unit` as the active texture unit and binds the texture to it.
+  // GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are tracked; other targets are
+  // always issued.
+  void BindTexture(GLuint unit, GLenum target, GLuint texture);
+  void SetBlend(bool enabled);
+  void BlendFunc(GLenum src, GLenum dst);
+  void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha,
+                         GLenum dstAlpha);
+  // GL_FUNC_ADD is what every other pass expects; a pass that switches to
+  // another equation switches back when it is done.
+  void BlendEquation(GLenum mode);
+  void SetDepthTest(bool enabled);
+  void SetDepthMask(bool enabled);
+  void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  void OnProgramDeleted(GLuint program);
+  void OnVertexArrayDeleted(GLuint vao);
+  void OnFramebufferDeleted(GLuint fbo);
+  void OnTextureDeleted(GLuint texture);
+
+  // Forgets everything; the next call of each kind is issued.
+  void Invalidate();
+
+  const Stats &GetStats() const { return stats_; }
+  void ResetStats() { stats_ = Stats{}; }
+
+private:
+  GLStateCache() { Invalidate(); }
+
+  static constexpr GLuint kUnknown = 0xFFFFFFFFu;
+  static constexpr int kTrackedTargets = 2; // 2D, cube map
+
+  // Counts the call and returns true if it has to reach the driver.
+  bool Changed(bool changed) {
+    if (changed) {
+      ++stats_.issued;
+    } else {
+      ++stats_.redundant;
+    }
+    return changed;
+  }
+
+  void SetCapability(GLenum cap, int &current, bool enabled);
+
+  GLuint program_ = kUnknown;
+  GLuint vao_ = kUnknown;
+  GLuint fbo_ = kUnknown;
+  GLuint activeUnit_ = kUnknown;
+  GLuint textures_[kTrackedTargets][kMaxTextureUnits] = {};
+  int blend_ = -1; // -1 = unknown
+  GLenum blendSrc_ = kUnknown;
+  GLenum blendDst_ = kUnknown;
+  GLenum blendSrcAlpha_ = kUnknown;
+  GLenum blendDstAlpha_ = kUnknown;
+  GLenum blendEquation_ = kUnknown;
+  int depthTest_ = -1;
+  int depthMask_ = -1;
+  GLint viewport_[4] = {};
+  bool viewportKnown_ = false;
+
+  Stats stats_;
+};
@@ -0,0 +1,67 @@
+#include "GpuTimer.h"
+
+GpuTimer::~GpuTimer() { Destroy(); }
+
+bool GpuTimer::Create() {
+  Destroy();
+  if (!glGenQueries || !glGetQueryObjectui64v) {
+    return false;
+  }
+  glGenQueries(kQueryCount, queries_);
+  return true;
+}
+
+void GpuTimer::Destroy() {
+  if (queries_[0]) {
+    glDeleteQueries(kQueryCount, queries_);
+  }
+  for (int i = 0; i < kQueryCount; ++i) {
+    queries_[i] = 0;
+    pending_[i] = false;
+  }
+  next_ = 0;
+  active_ = false;
+  lastMs_ = -1.0f;
+}
+
+// Walks the ring oldest-first so lastMs_ ends up holding the newest result.
+void GpuTimer::CollectResults() {
+  for (int n = 0; n < kQueryCount; ++n) {
+    const int i = (next_ + n) % kQueryCount;
+    if (!pending_[i]) {
+      continue;
+    }
+    GLint available = 0;
+    glGetQueryObjectiv(queries_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+      continue;
+    }
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(queries_[i], GL_QUERY_RESULT, &elapsedNs);
+    lastMs_ = static_cast<float>(static_cast<double>(elapsedNs) * 1.0e-6);
+    pending_[i] = false;
+  }
+}
+
+void GpuTimer::Begin() {
+  active_ = false;
+  if (!queries_[0]) {
+    return;
+  }
+  CollectResults();
+  if (pending_[next_]) {
+    return;
+  }
+  glBeginQuery(GL_TIME_ELAPSED, queries_[next_]);
+  active_ = true;
+}
+
+void GpuTimer::End() {
+  if (!active_) {
+    return;
+  }
+  glEndQuery(GL_TIME_ELAPSED);
+  pending_[next_] = true;
+  next_ = (next_ + 1) % kQueryCount;
+  active_ = false;
+}
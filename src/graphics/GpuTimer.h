@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../glad/glad.h"
+
+// Non-blocking GL_TIME_ELAPSED timer. Each Begin/End pair uses the next query
+// in a small ring and results are collected a few frames later, once the GPU
+// reports them available, so measuring never stalls the CPU. If every query
+// is still in flight the frame is simply not measured.
+//
+// Time-elapsed queries cannot nest: only one timer may be between Begin and
+// End at a time.
+class GpuTimer {
+public:
+  GpuTimer() = default;
+  ~GpuTimer();
+
+  GpuTimer(const GpuTimer &) = delete;
+  GpuTimer &operator=(const GpuTimer &) = delete;
+
+  // Returns false (and the timer stays inert) without timer query support.
+  bool Create();
+  void Destroy();
+
+  void Begin();
+  void End();
+
+  // Most recently completed measurement in milliseconds, or a negative value
+  // if nothing has completed yet.
+  float GetLastMs() const { return lastMs_; }
+
+private:
+  static constexpr int kQueryCount = 4;
+
+  void CollectResults();
+
+  GLuint queries_[kQueryCount] = {};
+  bool pending_[kQueryCount] = {};
+  int next_ = 0;
+  bool active_ = false;
+  float lastMs_ = -1.0f;
+};
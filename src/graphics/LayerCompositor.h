@@ -2,17 +2,61 @@
 
 #include "../Logger.h"
 #include "../glad/glad.h"
+#include "GLStateCache.h"
+#include "Mesh.h"
 #include "PostProcessConfig.h"
+#include "RenderTargetPool.h"
 #include "Shader.h"
+#include "ShaderPermutations.h"
 #include "VisualizerLayer.h"
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+// Final output stage features, one bit per define of the final.frag
+// permutation (see LayerCompositor::Present).
+namespace OutputBits {
+constexpr std::uint32_t Tonemap = 1u << 0;
+constexpr std::uint32_t Bloom = 1u << 1;
+constexpr std::uint32_t Fxaa = 1u << 2;
+constexpr std::uint32_t Vignette = 1u << 3;
+constexpr std::uint32_t Grain = 1u << 4;
+} // namespace OutputBits
+
+// Screen-wide settings of the final output stage.
+struct OutputSettings {
+  bool tonemap = false;
+  float exposure = 1.0f;
+  float bloomStrength = 0.0f; // Used when Present() is given a bloom level
+  bool fxaa = false;
+  bool vignette = false;
+  float vignetteIntensity = 0.3f;
+  float vignetteRadius = 0.8f;
+  bool grain = false;
+  float grainAmount = 0.03f;
+};
+
 // LayerCompositor - blends all visualizer layers into final output
 class LayerCompositor {
 public:
-  LayerCompositor() = default;
+  // Layers the fused composite shader can take in one pass; must match
+  // MAX_LAYERS in composite.frag.
+  static constexpr int kMaxFusedLayers = 4;
+
+  // Per-layer effects are compiled as layer_fx permutations; the define
+  // list is indexed by FXBits bit position.
+  LayerCompositor()
+      : m_fxPermutations("assets/shaders/passthrough.vert",
+                         "assets/shaders/layer_fx.frag",
+                         {"FX_BLOOM", "FX_GLOW", "FX_COLOR_GRADE",
+                          "FX_DISTORTION", "FX_CHROMATIC", "FX_VIGNETTE",
+                          "FX_SCAN_LINES", "FX_NOISE", "FX_PIXELATE",
+                          "FX_EDGE_GLOW", "FX_MOTION_BLUR", "FX_TRAILS"}),
+        m_outputPermutations("assets/shaders/passthrough.vert",
+                             "assets/shaders/final.frag",
+                             {"OUTPUT_TONEMAP", "OUTPUT_BLOOM", "OUTPUT_FXAA",
+                              "OUTPUT_VIGNETTE", "OUTPUT_GRAIN"}) {}
   ~LayerCompositor() { Cleanup(); }
 
   // Initialize with screen dimensions
@@ -20,162 +64,535 @@ public:
     m_width = width;
     m_height = height;
 
-    // Create output FBO for composited result
-    glGenFramebuffers(1, &m_outputFbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_outputFbo);
-
-    glGenTextures(1, &m_outputTex);
-    glBindTexture(GL_TEXTURE_2D, m_outputTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA,
-                 GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                           m_outputTex, 0);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-      Logger::LogS("Compositor FBO Incomplete!");
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // Initialize Shader
-    m_shader = std::make_unique<Shader>("assets/shaders/passthrough.vert",
-                                        "assets/shaders/passthrough.frag");
-
-    // Initialize Quad VAO
-    float quadVertices[] = {// positions   // texCoords
-                            -1.0f, 1.0f, 0.0f, 1.0f,  -1.0f, -1.0f,
-                            0.0f,  0.0f, 1.0f, -1.0f, 1.0f,  0.0f,
-
-                            -1.0f, 1.0f, 0.0f, 1.0f,  1.0f,  -1.0f,
-                            1.0f,  0.0f, 1.0f, 1.0f,  1.0f,  1.0f};
-
-    glGenVertexArrays(1, &m_quadVAO);
-    glGenBuffers(1, &m_quadVBO);
-    glBindVertexArray(m_quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices,
-                 GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
-                          (void *)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
-                          (void *)(2 * sizeof(float)));
-    glBindVertexArray(0);
+    // Initialize Shader. Built asynchronously alongside the scene shaders;
+    // until it is ready the output simply stays black.
+    m_shader = Shader::CreateAsync("assets/shaders/passthrough.vert",
+                                   "assets/shaders/passthrough.frag");
+    m_shaderReady = false;
+    m_fusedShader = Shader::CreateAsync("assets/shaders/passthrough.vert",
+                                        "assets/shaders/composite.frag");
+    m_fusedReady = false;
+
+    m_quad = CreateFullscreenQuadMesh();
 
     return true;
   }
 
+  // Only the screen size is kept here; targets come from the frame graph.
+  // Shaders, FX permutations and the quad survive a resize.
   void Resize(int width, int height) {
-    Cleanup();
-    Initialize(width, height);
+    m_width = width;
+    m_height = height;
+  }
+
+  // Animation time for the layer effects, in seconds.
+  void SetTime(float seconds) { m_time = seconds; }
+
+  // When enabled (the default), frames with at most kMaxFusedLayers
+  // visible layers are composited by a single shader that samples every
+  // layer and, with no output feature on, writes straight to the default
+  // framebuffer without a Present(). Per-layer effects are applied first
+  // with ApplyLayerFX().
+  void SetFusedComposite(bool enabled) { m_fusedEnabled = enabled; }
+  bool IsFusedComposite() const { return m_fusedEnabled; }
+
+  void SetOutputSettings(const OutputSettings &settings) {
+    m_output = settings;
   }
 
-  // Composite all layers in render order
-  void Composite(std::vector<VisualizerLayer *> &layers) {
-    // Sort by render order
+  // Output features Present() applies; `bloom` says whether it will be given
+  // a bloom level. Zero means the composite can go straight to the screen.
+  std::uint32_t GetOutputMask(bool bloom) const {
+    std::uint32_t mask = 0;
+    if (m_output.tonemap)
+      mask |= OutputBits::Tonemap;
+    if (bloom && m_output.bloomStrength > 0.0f)
+      mask |= OutputBits::Bloom;
+    if (m_output.fxaa)
+      mask |= OutputBits::Fxaa;
+    if (m_output.vignette && m_output.vignetteIntensity > 0.0f)
+      mask |= OutputBits::Vignette;
+    if (m_output.grain && m_output.grainAmount > 0.0f)
+      mask |= OutputBits::Grain;
+    return mask;
+  }
+
+  static void SortByRenderOrder(std::vector<VisualizerLayer *> &layers) {
     std::sort(layers.begin(), layers.end(),
               [](const VisualizerLayer *a, const VisualizerLayer *b) {
                 return a->GetRenderOrder() < b->GetRenderOrder();
               });
+  }
+
+  // True if this frame's layers can go through CompositeFused().
+  bool CanCompositeFused(const std::vector<VisualizerLayer *> &layers) {
+    return m_fusedEnabled && CanFuse(layers) && IsFusedShaderReady();
+  }
+
+  // One full-screen pass: reads each layer once and writes `target`
+  // (normally the backbuffer). Replaces a read-modify-write of the RGBA16F
+  // output per layer plus the Present() pass. Layers must be sorted.
+  // textures[i] is what to sample for layers[i]: its color texture, or the
+  // ApplyLayerFX() output for a layer with per-layer effects.
+  void CompositeFused(const std::vector<VisualizerLayer *> &layers,
+                      const GLuint *textures, const RenderTarget &target) {
+    DrawFused(layers, textures, target);
+  }
+
+  // Draws `layer` through its layer_fx permutation into `target`, a
+  // transient of the layer's size, at full opacity; the fused composite
+  // applies the opacity and blend mode. Until the permutation is built the
+  // layer is copied as is.
+  void ApplyLayerFX(const VisualizerLayer &layer, const RenderTarget &target) {
+    GLStateCache &gl = GLStateCache::Get();
+    gl.BindFramebuffer(target.fbo);
+    gl.Viewport(0, 0, target.desc.width, target.desc.height);
+    gl.SetBlend(false);
+    gl.SetDepthTest(false);
+
+    const auto &fx = layer.GetFXConfig();
+    const std::uint32_t fxMask = GetFXMask(fx) & FXBits::LayerPass;
+    Shader *fxShader = fxMask ? m_fxPermutations.Get(fxMask) : nullptr;
+    if (fxShader) {
+      DrawLayerWithFX(*fxShader, fxMask, layer, fx, 1.0f);
+    } else if (IsShaderReady()) {
+      DrawLayerTexture(layer.GetColorTexture(), 1.0f);
+    } else {
+      // Nothing can draw yet; pooled contents are undefined.
+      glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+      glClear(GL_COLOR_BUFFER_BIT);
+    }
+  }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_outputFbo);
-    glViewport(0, 0, m_width, m_height);
+  // Multi-pass composite of the sorted layers into `output`, one blended
+  // quad per layer.
+  void Composite(const std::vector<VisualizerLayer *> &layers,
+                 const RenderTarget &output) {
+    GLStateCache &gl = GLStateCache::Get();
+    gl.BindFramebuffer(output.fbo);
+    gl.Viewport(0, 0, output.desc.width, output.desc.height);
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f); // Clear to transparent
     glClear(GL_COLOR_BUFFER_BIT);
 
-    glEnable(GL_BLEND);
-    glDisable(GL_DEPTH_TEST); // Disable depth for 2D composition
+    gl.SetBlend(true);
+    gl.SetDepthTest(false); // Disable depth for 2D composition
 
     for (auto *layer : layers) {
-      if (!layer)
+      if (!layer || !layer->HasTargets())
         continue;
 
       const auto &fx = layer->GetFXConfig();
 
+      // The full-screen quad lands on the layer's rectangle.
+      const LayerRect &rect = layer->GetRect();
+      gl.Viewport(rect.x, rect.y, rect.width, rect.height);
+
       // Set blend mode based on layer config
       switch (fx.blendMode) {
       case BlendMode::Additive:
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        gl.BlendFunc(GL_SRC_ALPHA, GL_ONE);
         break;
       case BlendMode::Multiply:
-        glBlendFunc(GL_DST_COLOR, GL_ZERO);
+        gl.BlendFunc(GL_DST_COLOR, GL_ZERO);
         break;
       case BlendMode::Screen:
-        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+        gl.BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
         break;
       case BlendMode::Normal:
       default:
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         break;
       }
 
-      DrawLayerTexture(layer->GetColorTexture(), fx.opacity);
+      // Layers without single-pass effects, or whose permutation is still
+      // building, go through the plain passthrough shader.
+      const std::uint32_t fxMask = GetFXMask(fx) & FXBits::LayerPass;
+      Shader *fxShader = fxMask ? m_fxPermutations.Get(fxMask) : nullptr;
+      if (fxShader) {
+        DrawLayerWithFX(*fxShader, fxMask, *layer, fx, fx.opacity);
+      } else {
+        DrawLayerTexture(layer->GetColorTexture(), fx.opacity);
+      }
     }
+  }
+
+  // Draws the composited texture to the default framebuffer in one pass
+  // that also applies the enabled output features (tonemap, bloom level,
+  // FXAA, vignette, grain) through a final.frag permutation. `bloom` is the
+  // half-size level from BloomRenderer::AddChainPass, or nullptr. Until the
+  // variant is built the texture is copied as is.
+  void Present(const RenderTarget &source, const RenderTarget *bloom) {
+    GLStateCache &gl = GLStateCache::Get();
+    gl.BindFramebuffer(0);
+    gl.Viewport(0, 0, m_width, m_height);
+    // Every pixel is overwritten, so only depth needs clearing. glClear
+    // honours the depth write mask, so make sure it is on.
+    gl.SetDepthMask(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    gl.SetBlend(false);
+    gl.SetDepthTest(false); // 2D pass
 
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    const std::uint32_t mask = GetOutputMask(bloom != nullptr);
+    Shader *shader = mask ? m_outputPermutations.Get(mask) : nullptr;
+    if (shader) {
+      DrawOutput(*shader, mask, source, bloom);
+    } else {
+      DrawLayerTexture(source.colorTex, 1.0f);
+    }
   }
 
-  // Draw the final composited texture to the default framebuffer
-  void Present() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, m_width, m_height);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  void Cleanup() {
+    DestroyMesh(m_quad);
+    m_shader.reset();
+    m_shaderReady = false;
+    m_fusedShader.reset();
+    m_fusedReady = false;
+    m_fxPermutations.Clear();
+    m_outputPermutations.Clear();
+    m_fxUniforms.clear();
+    m_outputUniforms.clear();
+  }
 
-    glDisable(GL_DEPTH_TEST); // 2D pass
-    DrawLayerTexture(m_outputTex, 1.0f);
-    glEnable(GL_DEPTH_TEST);
+private:
+  // Collects the passthrough program once its build has finished.
+  bool IsShaderReady() {
+    if (m_shaderReady) {
+      return true;
+    }
+    if (!m_shader || !m_shader->Poll() || !m_shader->IsValid()) {
+      return false;
+    }
+    // The sampler unit never changes, so it is set once here.
+    m_shader->Use();
+    Uniform<int>(*m_shader, "screenTexture").Set(0);
+    m_opacityUniform = Uniform<float>(*m_shader, "opacity");
+    m_shaderReady = true;
+    return true;
   }
 
-  GLuint GetOutputTexture() const { return m_outputTex; }
+  // The fused shader reproduces the fixed-function blend modes for up to
+  // kMaxFusedLayers layers. It has no per-layer effects of its own; those
+  // come pre-applied (ApplyLayerFX).
+  static bool CanFuse(const std::vector<VisualizerLayer *> &layers) {
+    int count = 0;
+    for (const auto *layer : layers) {
+      if (!layer || !layer->HasTargets())
+        continue;
+      if (++count > kMaxFusedLayers) {
+        return false;
+      }
+    }
+    return count > 0;
+  }
 
-  void Cleanup() {
-    if (m_outputFbo) {
-      glDeleteFramebuffers(1, &m_outputFbo);
-      m_outputFbo = 0;
+  bool IsFusedShaderReady() {
+    if (m_fusedReady) {
+      return true;
     }
-    if (m_outputTex) {
-      glDeleteTextures(1, &m_outputTex);
-      m_outputTex = 0;
+    if (!m_fusedShader || !m_fusedShader->Poll() ||
+        !m_fusedShader->IsValid()) {
+      return false;
     }
-    if (m_quadVAO) {
-      glDeleteVertexArrays(1, &m_quadVAO);
-      m_quadVAO = 0;
+    // Layer i is always sampled from texture unit i.
+    GLint units[kMaxFusedLayers];
+    for (int i = 0; i < kMaxFusedLayers; ++i) {
+      units[i] = i;
     }
-    if (m_quadVBO) {
-      glDeleteBuffers(1, &m_quadVBO);
-      m_quadVBO = 0;
+    m_fusedShader->Use();
+    glUniform1iv(m_fusedShader->GetUniformLocation("uLayers"),
+                 kMaxFusedLayers, units);
+    m_fusedBlendModes = m_fusedShader->GetUniformLocation("uBlendModes");
+    m_fusedOpacities = m_fusedShader->GetUniformLocation("uOpacities");
+    m_fusedRects = m_fusedShader->GetUniformLocation("uLayerRects");
+    m_fusedLayerCount = Uniform<int>(*m_fusedShader, "uLayerCount");
+    m_fusedReady = true;
+    return true;
+  }
+
+  void DrawFused(const std::vector<VisualizerLayer *> &layers,
+                 const GLuint *textures, const RenderTarget &target) {
+    GLStateCache &gl = GLStateCache::Get();
+    GLint modes[kMaxFusedLayers] = {};
+    GLfloat opacities[kMaxFusedLayers] = {};
+    GLfloat rects[kMaxFusedLayers * 4] = {};
+    const float invWidth = 1.0f / static_cast<float>(m_width);
+    const float invHeight = 1.0f / static_cast<float>(m_height);
+    int count = 0;
+    for (std::size_t i = 0; i < layers.size(); ++i) {
+      const VisualizerLayer *layer = layers[i];
+      if (!layer || !layer->HasTargets())
+        continue;
+      const auto &fx = layer->GetFXConfig();
+      modes[count] = static_cast<GLint>(fx.blendMode);
+      opacities[count] = fx.opacity;
+      // Offset and size of the layer in screen UV space
+      const LayerRect &rect = layer->GetRect();
+      rects[count * 4 + 0] = static_cast<float>(rect.x) * invWidth;
+      rects[count * 4 + 1] = static_cast<float>(rect.y) * invHeight;
+      rects[count * 4 + 2] = static_cast<float>(rect.width) * invWidth;
+      rects[count * 4 + 3] = static_cast<float>(rect.height) * invHeight;
+      gl.BindTexture(static_cast<GLuint>(count), GL_TEXTURE_2D, textures[i]);
+      ++count;
     }
-    m_shader.reset();
+
+    gl.BindFramebuffer(target.fbo);
+    gl.Viewport(0, 0, target.desc.width, target.desc.height);
+    gl.SetBlend(false);
+    gl.SetDepthTest(false);
+    // Every pixel is overwritten, so only depth needs clearing.
+    gl.SetDepthMask(true);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    m_fusedShader->Use();
+    m_fusedLayerCount.Set(count);
+    glUniform1iv(m_fusedBlendModes, count, modes);
+    glUniform1fv(m_fusedOpacities, count, opacities);
+    glUniform4fv(m_fusedRects, count, rects);
+
+    DrawMesh(m_quad);
   }
 
-private:
   void DrawLayerTexture(GLuint texture, float opacity) {
-    if (m_shader) {
+    if (IsShaderReady()) {
       m_shader->Use();
-      m_shader->SetInt("screenTexture", 0);
-      m_shader->SetFloat("opacity", opacity);
+      m_opacityUniform.Set(opacity);
 
-      glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, texture);
+      GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, texture);
 
-      glBindVertexArray(m_quadVAO);
-      glDrawArrays(GL_TRIANGLES, 0, 6);
-      glBindVertexArray(0);
+      DrawMesh(m_quad);
     }
   }
 
-  GLuint m_outputFbo = 0;
-  GLuint m_outputTex = 0;
+  // Uniform handles of one layer_fx permutation, resolved the first time
+  // the variant is drawn. Uniforms of effects the variant leaves out stay
+  // at location -1, so setting them is a no-op.
+  struct LayerFXUniforms {
+    GLuint program = 0;
+    Uniform<float> opacity;
+    GLint texelSize = -1;
+    Uniform<float> time;
+    Uniform<Vec3> glowColor;
+    Uniform<float> glowIntensity;
+    Uniform<float> glowSize;
+    Uniform<float> brightness;
+    Uniform<float> contrast;
+    Uniform<float> saturation;
+    Uniform<float> hueShift;
+    Uniform<Vec3> tintColor;
+    Uniform<float> tintStrength;
+    Uniform<float> distortionAmount;
+    Uniform<float> distortionFreq;
+    Uniform<float> distortionSpeed;
+    Uniform<float> chromaticOffset;
+    Uniform<float> chromaticFalloff;
+    Uniform<float> vignetteIntensity;
+    Uniform<float> vignetteRadius;
+    Uniform<Vec3> vignetteColor;
+    Uniform<float> scanLinesDensity;
+    Uniform<float> scanLinesIntensity;
+    Uniform<float> scanLinesSpeed;
+    Uniform<float> noiseAmount;
+    Uniform<float> noiseSeed;
+    Uniform<float> pixelateSize;
+    Uniform<Vec3> edgeGlowColor;
+    Uniform<float> edgeGlowWidth;
+    Uniform<float> edgeGlowIntensity;
+  };
+
+  // Same for the final.frag permutations.
+  struct OutputUniforms {
+    GLuint program = 0;
+    GLint texelSize = -1;
+    GLint bloomTexelSize = -1;
+    Uniform<float> bloomStrength;
+    Uniform<float> exposure;
+    Uniform<float> vignetteIntensity;
+    Uniform<float> vignetteRadius;
+    Uniform<float> grainAmount;
+    Uniform<float> time;
+  };
+
+  static Vec3 ToVec3(const float (&color)[3]) {
+    return {color[0], color[1], color[2]};
+  }
+
+  // Handles for the variant of `mask`, resolved again if the variant was
+  // rebuilt. The samplers never change unit, so they are set here once.
+  // Leaves `shader` current.
+  const LayerFXUniforms &GetLayerFXUniforms(Shader &shader,
+                                            std::uint32_t mask) {
+    LayerFXUniforms &u = m_fxUniforms[mask];
+    shader.Use();
+    if (u.program == shader.GetId()) {
+      return u;
+    }
+    u.program = shader.GetId();
+    Uniform<int>(shader, "screenTexture").Set(0);
+    u.opacity = Uniform<float>(shader, "opacity");
+    u.texelSize = shader.GetUniformLocation("uTexelSize");
+    u.time = Uniform<float>(shader, "uTime");
+    u.glowColor = Uniform<Vec3>(shader, "uGlowColor");
+    u.glowIntensity = Uniform<float>(shader, "uGlowIntensity");
+    u.glowSize = Uniform<float>(shader, "uGlowSize");
+    u.brightness = Uniform<float>(shader, "uBrightness");
+    u.contrast = Uniform<float>(shader, "uContrast");
+    u.saturation = Uniform<float>(shader, "uSaturation");
+    u.hueShift = Uniform<float>(shader, "uHueShift");
+    u.tintColor = Uniform<Vec3>(shader, "uTintColor");
+    u.tintStrength = Uniform<float>(shader, "uTintStrength");
+    u.distortionAmount = Uniform<float>(shader, "uDistortionAmount");
+    u.distortionFreq = Uniform<float>(shader, "uDistortionFreq");
+    u.distortionSpeed = Uniform<float>(shader, "uDistortionSpeed");
+    u.chromaticOffset = Uniform<float>(shader, "uChromaticOffset");
+    u.chromaticFalloff = Uniform<float>(shader, "uChromaticFalloff");
+    u.vignetteIntensity = Uniform<float>(shader, "uVignetteIntensity");
+    u.vignetteRadius = Uniform<float>(shader, "uVignetteRadius");
+    u.vignetteColor = Uniform<Vec3>(shader, "uVignetteColor");
+    u.scanLinesDensity = Uniform<float>(shader, "uScanLinesDensity");
+    u.scanLinesIntensity = Uniform<float>(shader, "uScanLinesIntensity");
+    u.scanLinesSpeed = Uniform<float>(shader, "uScanLinesSpeed");
+    u.noiseAmount = Uniform<float>(shader, "uNoiseAmount");
+    u.noiseSeed = Uniform<float>(shader, "uNoiseSeed");
+    u.pixelateSize = Uniform<float>(shader, "uPixelateSize");
+    u.edgeGlowColor = Uniform<Vec3>(shader, "uEdgeGlowColor");
+    u.edgeGlowWidth = Uniform<float>(shader, "uEdgeGlowWidth");
+    u.edgeGlowIntensity = Uniform<float>(shader, "uEdgeGlowIntensity");
+    return u;
+  }
+
+  const OutputUniforms &GetOutputUniforms(Shader &shader, std::uint32_t mask) {
+    OutputUniforms &u = m_outputUniforms[mask];
+    shader.Use();
+    if (u.program == shader.GetId()) {
+      return u;
+    }
+    u.program = shader.GetId();
+    Uniform<int>(shader, "screenTexture").Set(0);
+    Uniform<int>(shader, "uBloomTexture").Set(1);
+    u.texelSize = shader.GetUniformLocation("uTexelSize");
+    u.bloomTexelSize = shader.GetUniformLocation("uBloomTexelSize");
+    u.bloomStrength = Uniform<float>(shader, "uBloomStrength");
+    u.exposure = Uniform<float>(shader, "uExposure");
+    u.vignetteIntensity = Uniform<float>(shader, "uVignetteIntensity");
+    u.vignetteRadius = Uniform<float>(shader, "uVignetteRadius");
+    u.grainAmount = Uniform<float>(shader, "uGrainAmount");
+    u.time = Uniform<float>(shader, "uTime");
+    return u;
+  }
+
+  // Draws a layer through its layer_fx permutation, using the handles
+  // cached for that variant.
+  void DrawLayerWithFX(Shader &shader, std::uint32_t mask,
+                       const VisualizerLayer &layer,
+                       const PostProcessConfig &fx, float opacity) {
+    const GLuint texture = layer.GetColorTexture();
+    const LayerFXUniforms &u = GetLayerFXUniforms(shader, mask);
+    u.opacity.Set(opacity);
+    glUniform2f(u.texelSize, 1.0f / static_cast<float>(layer.GetWidth()),
+                1.0f / static_cast<float>(layer.GetHeight()));
+    u.time.Set(m_time);
+
+    if (mask & FXBits::Glow) {
+      u.glowColor.Set(ToVec3(fx.glowColor));
+      u.glowIntensity.Set(fx.glowIntensity);
+      u.glowSize.Set(fx.glowSize);
+    }
+    if (mask & FXBits::ColorGrade) {
+      u.brightness.Set(fx.brightness);
+      u.contrast.Set(fx.contrast);
+      u.saturation.Set(fx.saturation);
+      u.hueShift.Set(fx.hueShift);
+      u.tintColor.Set(ToVec3(fx.tintColor));
+      u.tintStrength.Set(fx.tintStrength);
+    }
+    if (mask & FXBits::Distortion) {
+      u.distortionAmount.Set(fx.distortionAmount);
+      u.distortionFreq.Set(fx.distortionFreq);
+      u.distortionSpeed.Set(fx.distortionSpeed);
+    }
+    if (mask & FXBits::Chromatic) {
+      u.chromaticOffset.Set(fx.chromaticOffset);
+      u.chromaticFalloff.Set(fx.chromaticFalloff);
+    }
+    if (mask & FXBits::Vignette) {
+      u.vignetteIntensity.Set(fx.vignetteIntensity);
+      u.vignetteRadius.Set(fx.vignetteRadius);
+      u.vignetteColor.Set(ToVec3(fx.vignetteColor));
+    }
+    if (mask & FXBits::ScanLines) {
+      u.scanLinesDensity.Set(fx.scanLinesDensity);
+      u.scanLinesIntensity.Set(fx.scanLinesIntensity);
+      u.scanLinesSpeed.Set(fx.scanLinesSpeed);
+    }
+    if (mask & FXBits::Noise) {
+      u.noiseAmount.Set(fx.noiseAmount);
+      u.noiseSeed.Set(fx.noiseAnimated ? m_time : 0.0f);
+    }
+    if (mask & FXBits::Pixelate) {
+      u.pixelateSize.Set(fx.pixelateSize);
+    }
+    if (mask & FXBits::EdgeGlow) {
+      u.edgeGlowColor.Set(ToVec3(fx.edgeGlowColor));
+      u.edgeGlowWidth.Set(fx.edgeGlowWidth);
+      u.edgeGlowIntensity.Set(fx.edgeGlowIntensity);
+    }
+
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, texture);
+
+    DrawMesh(m_quad);
+  }
+
+  void DrawOutput(Shader &shader, std::uint32_t mask,
+                  const RenderTarget &source, const RenderTarget *bloom) {
+    GLStateCache &gl = GLStateCache::Get();
+    const OutputUniforms &u = GetOutputUniforms(shader, mask);
+    glUniform2f(u.texelSize, 1.0f / static_cast<float>(source.desc.width),
+                1.0f / static_cast<float>(source.desc.height));
+    gl.BindTexture(0, GL_TEXTURE_2D, source.colorTex);
+
+    if (mask & OutputBits::Bloom) {
+      glUniform2f(u.bloomTexelSize,
+                  1.0f / static_cast<float>(bloom->desc.width),
+                  1.0f / static_cast<float>(bloom->desc.height));
+      u.bloomStrength.Set(m_output.bloomStrength);
+      gl.BindTexture(1, GL_TEXTURE_2D, bloom->colorTex);
+    }
+    if (mask & OutputBits::Tonemap) {
+      u.exposure.Set(m_output.exposure);
+    }
+    if (mask & OutputBits::Vignette) {
+      u.vignetteIntensity.Set(m_output.vignetteIntensity);
+      u.vignetteRadius.Set(m_output.vignetteRadius);
+    }
+    if (mask & OutputBits::Grain) {
+      u.grainAmount.Set(m_output.grainAmount);
+      u.time.Set(m_time);
+    }
+
+    DrawMesh(m_quad);
+  }
+
   int m_width = 0;
   int m_height = 0;
+  float m_time = 0.0f;
 
   std::unique_ptr<Shader> m_shader;
-  GLuint m_quadVAO = 0;
-  GLuint m_quadVBO = 0;
+  Uniform<float> m_opacityUniform;
+  bool m_shaderReady = false;
+  ShaderPermutationCache m_fxPermutations;
+  ShaderPermutationCache m_outputPermutations;
+  // Handles per permutation, keyed by the same mask as the caches above.
+  std::unordered_map<std::uint32_t, LayerFXUniforms> m_fxUniforms;
+  std::unordered_map<std::uint32_t, OutputUniforms> m_outputUniforms;
+  OutputSettings m_output;
+
+  std::unique_ptr<Shader> m_fusedShader;
+  GLint m_fusedBlendModes = -1;
+  GLint m_fusedOpacities = -1;
+  GLint m_fusedRects = -1;
+  Uniform<int> m_fusedLayerCount;
+  bool m_fusedReady = false;
+  bool m_fusedEnabled = true;
+  Mesh m_quad; // Fullscreen quad
 };
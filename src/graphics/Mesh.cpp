@@ -1,5 +1,7 @@
 #include "Mesh.h"
 
+#include "GLStateCache.h"
+
 Mesh CreateCubeMesh() {
   Mesh mesh{};
   float vertices[] = {
@@ -36,7 +38,7 @@ Mesh CreateCubeMesh() {
 
   glGenVertexArrays(1, &mesh.vao);
   glGenBuffers(1, &mesh.vbo);
-  glBindVertexArray(mesh.vao);
+  GLStateCache::Get().BindVertexArray(mesh.vao);
   glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
   glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
   glEnableVertexAttribArray(0);
@@ -45,7 +47,7 @@ Mesh CreateCubeMesh() {
   glEnableVertexAttribArray(1);
   glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
                         reinterpret_cast<void *>(3 * sizeof(float)));
-  glBindVertexArray(0);
+  GLStateCache::Get().BindVertexArray(0);
 
   mesh.vertexCount =
       static_cast<GLsizei>(sizeof(vertices) / (6 * sizeof(float)));
@@ -101,7 +103,7 @@ Mesh CreateSphereMesh(int slices, int stacks) {
   glGenBuffers(1, &mesh.vbo);
   glGenBuffers(1, &mesh.ebo);
 
-  glBindVertexArray(mesh.vao);
+  GLStateCache::Get().BindVertexArray(mesh.vao);
   glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
   glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
                vertices.data(), GL_STATIC_DRAW);
@@ -114,7 +116,7 @@ Mesh CreateSphereMesh(int slices, int stacks) {
   glEnableVertexAttribArray(1);
   glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
                         reinterpret_cast<void *>(3 * sizeof(float)));
-  glBindVertexArray(0);
+  GLStateCache::Get().BindVertexArray(0);
 
   mesh.indexCount = static_cast<GLsizei>(indices.size());
   mesh.indexed = true;
@@ -155,7 +157,7 @@ Mesh CreateRingMesh(int segments, float innerRadius, float outerRadius) {
   glGenBuffers(1, &mesh.vbo);
   glGenBuffers(1, &mesh.ebo);
 
-  glBindVertexArray(mesh.vao);
+  GLStateCache::Get().BindVertexArray(mesh.vao);
   glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
   glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
                vertices.data(), GL_STATIC_DRAW);
@@ -168,13 +170,43 @@ Mesh CreateRingMesh(int segments, float innerRadius, float outerRadius) {
   glEnableVertexAttribArray(1);
   glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
                         reinterpret_cast<void *>(3 * sizeof(float)));
-  glBindVertexArray(0);
+  GLStateCache::Get().BindVertexArray(0);
 
   mesh.indexCount = static_cast<GLsizei>(indices.size());
   mesh.indexed = true;
   return mesh;
 }
 
+Mesh CreateFullscreenQuadMesh() {
+  Mesh mesh{};
+  const float vertices[] = {
+      // positions   // texCoords
+      -1.0f, 1.0f,  0.0f, 1.0f, //
+      -1.0f, -1.0f, 0.0f, 0.0f, //
+      1.0f,  -1.0f, 1.0f, 0.0f, //
+
+      -1.0f, 1.0f,  0.0f, 1.0f, //
+      1.0f,  -1.0f, 1.0f, 0.0f, //
+      1.0f,  1.0f,  1.0f, 1.0f, //
+  };
+
+  glGenVertexArrays(1, &mesh.vao);
+  glGenBuffers(1, &mesh.vbo);
+  GLStateCache::Get().BindVertexArray(mesh.vao);
+  glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        reinterpret_cast<void *>(0));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        reinterpret_cast<void *>(2 * sizeof(float)));
+  GLStateCache::Get().BindVertexArray(0);
+
+  mesh.vertexCount = 6;
+  return mesh;
+}
+
 void DestroyMesh(Mesh &mesh) {
   if (mesh.ebo) {
     glDeleteBuffers(1, &mesh.ebo);
@@ -183,17 +215,17 @@ void DestroyMesh(Mesh &mesh) {
     glDeleteBuffers(1, &mesh.vbo);
   }
   if (mesh.vao) {
+    GLStateCache::Get().OnVertexArrayDeleted(mesh.vao);
     glDeleteVertexArrays(1, &mesh.vao);
   }
   mesh = {};
 }
 
 void DrawMesh(const Mesh &mesh) {
-  glBindVertexArray(mesh.vao);
+  GLStateCache::Get().BindVertexArray(mesh.vao);
   if (mesh.indexed) {
     glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
   } else {
     glDrawArrays(GL_TRIANGLES, 0, mesh.vertexCount);
   }
-  glBindVertexArray(0);
 }
@@ -19,6 +19,9 @@ struct Mesh {
 Mesh CreateCubeMesh();
 Mesh CreateSphereMesh(int slices, int stacks);
 Mesh CreateRingMesh(int segments, float innerRadius, float outerRadius);
+// Two triangles covering clip space; location 0 is the vec2 position and
+// location 1 the vec2 texture coordinate (passthrough.vert/fullscreen.vert).
+Mesh CreateFullscreenQuadMesh();
 
 // Mesh lifecycle
 void DestroyMesh(Mesh &mesh);
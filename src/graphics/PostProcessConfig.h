@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cmath>
+#include <cstdint>
 
 // Blend modes for layer compositing
 enum class BlendMode {
@@ -149,7 +151,7 @@ struct PostProcessConfig {
 
   // === TRAILS / PERSISTENCE ===
   bool trailsEnabled = false;
-  float trailsFade = 0.9f; // How fast trails fade (0-1)
+  float trailsFade = 0.9f; // History kept per 1/60 s (0-1)
 
   // === LAYER COMPOSITING ===
   float opacity = 1.0f; // Layer opacity (0-1)
@@ -157,6 +159,80 @@ struct PostProcessConfig {
   int renderOrder = 0; // Lower = rendered first (background)
 };
 
+// One bit per effect in PostProcessConfig. The layer FX shader is built as a
+// permutation per combination of enabled bits (see GetFXMask).
+namespace FXBits {
+constexpr std::uint32_t Bloom = 1u << 0;
+constexpr std::uint32_t Glow = 1u << 1;
+constexpr std::uint32_t ColorGrade = 1u << 2;
+constexpr std::uint32_t Distortion = 1u << 3;
+constexpr std::uint32_t Chromatic = 1u << 4;
+constexpr std::uint32_t Vignette = 1u << 5;
+constexpr std::uint32_t ScanLines = 1u << 6;
+constexpr std::uint32_t Noise = 1u << 7;
+constexpr std::uint32_t Pixelate = 1u << 8;
+constexpr std::uint32_t EdgeGlow = 1u << 9;
+constexpr std::uint32_t MotionBlur = 1u << 10;
+constexpr std::uint32_t Trails = 1u << 11;
+constexpr int Count = 12;
+
+// Effects that run inside the single-pass layer FX shader. Bloom, motion
+// blur and trails need extra passes or history and are handled separately.
+constexpr std::uint32_t LayerPass = Glow | ColorGrade | Distortion |
+                                    Chromatic | Vignette | ScanLines | Noise |
+                                    Pixelate | EdgeGlow;
+} // namespace FXBits
+
+// trailsFade is the share of the trail history kept over one frame at
+// this rate. Passes scale it to their real frame time, so a trail lasts
+// the same number of seconds at 60, 144 or 240 Hz.
+constexpr float kTrailFadeReferenceHz = 60.0f;
+
+// History kept over `seconds`.
+inline float TrailFadeOver(float trailsFade, float seconds) {
+  return std::pow(trailsFade, seconds * kTrailFadeReferenceHz);
+}
+
+// Trails whose echo after one reference frame (layer opacity * fade) is
+// under one 8-bit step are never visible, so they do not count as enabled.
+constexpr float kMinVisibleTrailFade = 1.0f / 255.0f;
+
+inline std::uint32_t GetFXMask(const PostProcessConfig &cfg) {
+  std::uint32_t mask = 0;
+  if (cfg.bloomEnabled && cfg.bloomIntensity > 0.0f)
+    mask |= FXBits::Bloom;
+  if (cfg.glowEnabled && cfg.glowIntensity > 0.0f)
+    mask |= FXBits::Glow;
+  // Color adjustments have no toggle; they count as enabled once any of them
+  // moves away from its identity value.
+  if (cfg.brightness != 1.0f || cfg.contrast != 1.0f ||
+      cfg.saturation != 1.0f || cfg.hueShift != 0.0f ||
+      cfg.tintStrength > 0.0f)
+    mask |= FXBits::ColorGrade;
+  if (cfg.distortionEnabled && cfg.distortionAmount != 0.0f)
+    mask |= FXBits::Distortion;
+  if (cfg.chromaticEnabled && cfg.chromaticOffset != 0.0f)
+    mask |= FXBits::Chromatic;
+  if (cfg.vignetteEnabled && cfg.vignetteIntensity > 0.0f)
+    mask |= FXBits::Vignette;
+  if (cfg.scanLinesEnabled && cfg.scanLinesIntensity > 0.0f)
+    mask |= FXBits::ScanLines;
+  if (cfg.noiseEnabled && cfg.noiseAmount > 0.0f)
+    mask |= FXBits::Noise;
+  if (cfg.pixelateEnabled && cfg.pixelateSize > 1.0f)
+    mask |= FXBits::Pixelate;
+  if (cfg.edgeGlowEnabled && cfg.edgeGlowIntensity > 0.0f)
+    mask |= FXBits::EdgeGlow;
+  if (cfg.motionBlurEnabled && cfg.motionBlurAmount > 0.0f)
+    mask |= FXBits::MotionBlur;
+  if (cfg.trailsEnabled &&
+      TrailFadeOver(cfg.trailsFade, 1.0f / kTrailFadeReferenceHz) *
+              cfg.opacity >=
+          kMinVisibleTrailFade)
+    mask |= FXBits::Trails;
+  return mask;
+}
+
 // Default FX presets for each metric type
 namespace FXPresets {
 
@@ -0,0 +1,156 @@
+#include "ProgramCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <windows.h>
+
+#include "../Logger.h"
+#include "GLCapabilities.h"
+
+namespace {
+constexpr std::uint32_t kEntryMagic = 0x43425053; // "SPBC"
+// Bump when the entry layout changes so stale files are ignored.
+constexpr std::uint32_t kEntryVersion = 1;
+
+struct EntryHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t binaryFormat;
+  std::uint32_t length;
+};
+
+// FNV-1a, 64-bit. Each input is prefixed with its length so that moving
+// text from one stage to another changes the key.
+std::uint64_t HashBytes(std::uint64_t hash, const void *data,
+                        std::size_t size) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+std::uint64_t HashString(std::uint64_t hash, const std::string &value) {
+  const std::uint64_t length = value.size();
+  hash = HashBytes(hash, &length, sizeof(length));
+  return HashBytes(hash, value.data(), value.size());
+}
+} // namespace
+
+ProgramCache &ProgramCache::Get() {
+  static ProgramCache cache;
+  return cache;
+}
+
+ProgramCache::ProgramCache() {
+  const GLCapabilities &caps = GLCapabilities::Get();
+  if (!caps.SupportsProgramBinary()) {
+    Logger::LogS("Program binary cache disabled: no driver support");
+    return;
+  }
+  driverId_ = caps.GetVendor() + '\n' + caps.GetRenderer() + '\n' +
+              caps.GetVersionString();
+
+  char path[MAX_PATH];
+  GetModuleFileNameA(NULL, path, MAX_PATH);
+  directory_ =
+      std::filesystem::path(path).parent_path() / ".out" / "cache" / "shaders";
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  enabled_ = !ec;
+  if (!enabled_) {
+    Logger::LogS("Program binary cache disabled: cannot create " +
+                 directory_.string());
+  }
+}
+
+std::uint64_t
+ProgramCache::MakeKey(const std::vector<std::string> &inputs) const {
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  hash = HashString(hash, driverId_);
+  for (const std::string &input : inputs) {
+    hash = HashString(hash, input);
+  }
+  return hash;
+}
+
+std::filesystem::path ProgramCache::EntryPath(std::uint64_t key) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin",
+                static_cast<unsigned long long>(key));
+  return directory_ / name;
+}
+
+bool ProgramCache::Load(GLuint program, std::uint64_t key) const {
+  if (!enabled_) {
+    return false;
+  }
+
+  const std::filesystem::path path = EntryPath(key);
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  EntryHeader header{};
+  std::vector<char> binary;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  bool valid = file.good() && header.magic == kEntryMagic &&
+               header.version == kEntryVersion && header.length > 0;
+  if (valid) {
+    binary.resize(header.length);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    valid = file.gcount() == static_cast<std::streamsize>(binary.size());
+  }
+  file.close();
+
+  GLint linked = GL_FALSE;
+  if (valid) {
+    glProgramBinary(program, header.binaryFormat, binary.data(),
+                    static_cast<GLsizei>(binary.size()));
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  }
+
+  if (!linked) {
+    Logger::LogS("Discarding rejected program binary " +
+                 path.filename().string());
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return false;
+  }
+  return true;
+}
+
+void ProgramCache::Store(GLuint program, std::uint64_t key) const {
+  if (!enabled_) {
+    return;
+  }
+
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  std::vector<char> binary(static_cast<std::size_t>(length));
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &written, &format, binary.data());
+  if (written <= 0) {
+    return;
+  }
+
+  EntryHeader header{kEntryMagic, kEntryVersion, format,
+                     static_cast<std::uint32_t>(written)};
+  const std::filesystem::path path = EntryPath(key);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(binary.data(), written);
+  if (!file.good()) {
+    Logger::LogS("Failed to write program binary " + path.string());
+    file.close();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+  }
+}
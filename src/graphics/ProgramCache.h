@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../glad/glad.h"
+
+// On-disk cache of linked program binaries, stored under the SSOT output
+// root in <exe dir>/.out/cache/shaders/.
+//
+// Entries are keyed by a hash of every input that affects the link (stage
+// sources, transform feedback varyings) together with the driver's vendor,
+// renderer and version strings, so a driver update simply misses. A driver
+// may still reject a binary it produced earlier; Load() then deletes the
+// entry and the caller compiles from source as usual.
+class ProgramCache {
+public:
+  // Must not be called before the context is current (see GLCapabilities).
+  static ProgramCache &Get();
+
+  bool IsEnabled() const { return enabled_; }
+
+  std::uint64_t MakeKey(const std::vector<std::string> &inputs) const;
+
+  // Loads the entry for `key` into `program`, which must be a freshly created
+  // program with nothing attached. Returns true only if the driver accepted
+  // the binary and the program is linked.
+  bool Load(GLuint program, std::uint64_t key) const;
+  // Saves a linked program that was created with
+  // GL_PROGRAM_BINARY_RETRIEVABLE_HINT. Failures are logged and ignored.
+  void Store(GLuint program, std::uint64_t key) const;
+
+private:
+  ProgramCache();
+
+  std::filesystem::path EntryPath(std::uint64_t key) const;
+
+  bool enabled_ = false;
+  std::filesystem::path directory_;
+  std::string driverId_;
+};
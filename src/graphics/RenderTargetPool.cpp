@@ -0,0 +1,172 @@
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+
+#include "../Logger.h"
+#include "GLStateCache.h"
+
+namespace {
+// Pixel transfer format for an internal format. No data is uploaded, but
+// glTexImage2D still needs a compatible combination.
+GLenum TransferFormat(GLenum internalFormat) {
+  switch (internalFormat) {
+  case GL_DEPTH_COMPONENT:
+  case GL_DEPTH_COMPONENT24:
+    return GL_DEPTH_COMPONENT;
+  case GL_R11F_G11F_B10F:
+    return GL_RGB;
+  default:
+    return GL_RGBA;
+  }
+}
+
+std::size_t BytesPerPixel(GLenum internalFormat) {
+  switch (internalFormat) {
+  case 0:
+    return 0;
+  case GL_RGBA16F:
+    return 8;
+  case GL_DEPTH_COMPONENT:
+  case GL_DEPTH_COMPONENT24:
+  case GL_R11F_G11F_B10F:
+  case GL_RGBA8:
+  default:
+    return 4;
+  }
+}
+
+GLuint CreateTexture(GLenum internalFormat, int width, int height,
+                     GLint filter) {
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width,
+               height, 0, TransferFormat(internalFormat), GL_FLOAT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  return texture;
+}
+} // namespace
+
+RenderTargetPool &RenderTargetPool::Get() {
+  static RenderTargetPool pool;
+  return pool;
+}
+
+RenderTarget *RenderTargetPool::Acquire(const RenderTargetDesc &desc) {
+  for (Entry &entry : entries_) {
+    if (!entry.inUse && entry.target->desc == desc) {
+      entry.inUse = true;
+      entry.lastUsedFrame = frame_;
+      return entry.target.get();
+    }
+  }
+
+  auto target = std::make_unique<RenderTarget>();
+  target->desc = desc;
+  if (!Create(*target)) {
+    Logger::LogS("Render target incomplete: " + std::to_string(desc.width) +
+                 "x" + std::to_string(desc.height));
+    Destroy(*target);
+    return nullptr;
+  }
+
+  Entry entry;
+  entry.target = std::move(target);
+  entry.inUse = true;
+  entry.lastUsedFrame = frame_;
+  entries_.push_back(std::move(entry));
+  return entries_.back().target.get();
+}
+
+void RenderTargetPool::Release(RenderTarget *target) {
+  if (!target) {
+    return;
+  }
+  for (Entry &entry : entries_) {
+    if (entry.target.get() == target) {
+      entry.inUse = false;
+      entry.lastUsedFrame = frame_;
+      return;
+    }
+  }
+}
+
+void RenderTargetPool::EndFrame() {
+  ++frame_;
+  auto stale = std::remove_if(
+      entries_.begin(), entries_.end(), [this](Entry &entry) {
+        if (entry.inUse || frame_ - entry.lastUsedFrame < kEvictAfterFrames) {
+          return false;
+        }
+        Destroy(*entry.target);
+        return true;
+      });
+  entries_.erase(stale, entries_.end());
+}
+
+void RenderTargetPool::Clear() {
+  for (Entry &entry : entries_) {
+    Destroy(*entry.target);
+  }
+  entries_.clear();
+}
+
+std::size_t RenderTargetPool::GetAllocatedBytes() const {
+  std::size_t bytes = 0;
+  for (const Entry &entry : entries_) {
+    const RenderTargetDesc &desc = entry.target->desc;
+    const std::size_t pixels = static_cast<std::size_t>(desc.width) *
+                               static_cast<std::size_t>(desc.height);
+    bytes += pixels * (BytesPerPixel(desc.colorFormat) +
+                       BytesPerPixel(desc.depthFormat));
+  }
+  return bytes;
+}
+
+bool RenderTargetPool::Create(RenderTarget &target) {
+  const RenderTargetDesc &desc = target.desc;
+  GLStateCache &gl = GLStateCache::Get();
+
+  glGenFramebuffers(1, &target.fbo);
+  gl.BindFramebuffer(target.fbo);
+
+  if (desc.colorFormat) {
+    target.colorTex =
+        CreateTexture(desc.colorFormat, desc.width, desc.height, GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, target.colorTex, 0);
+  }
+  if (desc.depthFormat) {
+    target.depthTex =
+        CreateTexture(desc.depthFormat, desc.width, desc.height, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
+                           target.depthTex, 0);
+  }
+
+  const bool complete =
+      glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  gl.BindFramebuffer(0);
+  return complete;
+}
+
+void RenderTargetPool::Destroy(RenderTarget &target) {
+  GLStateCache &gl = GLStateCache::Get();
+  if (target.fbo) {
+    gl.OnFramebufferDeleted(target.fbo);
+    glDeleteFramebuffers(1, &target.fbo);
+    target.fbo = 0;
+  }
+  if (target.colorTex) {
+    gl.OnTextureDeleted(target.colorTex);
+    glDeleteTextures(1, &target.colorTex);
+    target.colorTex = 0;
+  }
+  if (target.depthTex) {
+    gl.OnTextureDeleted(target.depthTex);
+    glDeleteTextures(1, &target.depthTex);
+    target.depthTex = 0;
+  }
+}
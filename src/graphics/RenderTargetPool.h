@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../glad/glad.h"
+
+// Size and formats of a render target. A format of 0 means the attachment
+// is not present.
+struct RenderTargetDesc {
+  int width = 0;
+  int height = 0;
+  GLenum colorFormat = GL_RGBA16F;
+  GLenum depthFormat = 0; // e.g. GL_DEPTH_COMPONENT24
+
+  bool operator==(const RenderTargetDesc &other) const {
+    return width == other.width && height == other.height &&
+           colorFormat == other.colorFormat &&
+           depthFormat == other.depthFormat;
+  }
+  bool operator!=(const RenderTargetDesc &other) const {
+    return !(*this == other);
+  }
+};
+
+// An FBO with its attachments. Color textures are linear-filtered and
+// clamped to edge; the depth texture is nearest-filtered.
+struct RenderTarget {
+  RenderTargetDesc desc;
+  GLuint fbo = 0;
+  GLuint colorTex = 0;
+  GLuint depthTex = 0;
+};
+
+// Shared pool of render targets keyed by RenderTargetDesc.
+//
+// Acquire() hands out a released target with the same description when
+// there is one, so passes whose lifetimes do not overlap (acquire, draw,
+// sample, release) end up sharing the same memory. Long-lived targets such
+// as a layer's color buffer are simply held until their owner releases
+// them. Released targets that nobody reuses for kEvictAfterFrames frames
+// are destroyed, which is what cleans up old sizes after a resize.
+//
+// Acquired contents are undefined; every user clears or fully overwrites.
+class RenderTargetPool {
+public:
+  static constexpr std::uint64_t kEvictAfterFrames = 120;
+
+  static RenderTargetPool &Get();
+
+  RenderTargetPool(const RenderTargetPool &) = delete;
+  RenderTargetPool &operator=(const RenderTargetPool &) = delete;
+
+  // Returns nullptr if the framebuffer turns out incomplete.
+  RenderTarget *Acquire(const RenderTargetDesc &desc);
+  // Returns the target to the pool. Passing nullptr is a no-op.
+  void Release(RenderTarget *target);
+
+  // Advances the frame counter and destroys stale released targets.
+  void EndFrame();
+  // Destroys every target, acquired or not. Call before the context goes
+  // away, once all owners have released theirs.
+  void Clear();
+
+  // Video memory held by the pool, acquired and released, in bytes.
+  std::size_t GetAllocatedBytes() const;
+
+private:
+  RenderTargetPool() = default;
+
+  struct Entry {
+    std::unique_ptr<RenderTarget> target;
+    bool inUse = false;
+    std::uint64_t lastUsedFrame = 0;
+  };
+
+  static bool Create(RenderTarget &target);
+  static void Destroy(RenderTarget &target);
+
+  std::vector<Entry> entries_;
+  std::uint64_t frame_ = 0;
+};
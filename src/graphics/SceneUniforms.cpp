@@ -0,0 +1,72 @@
+#include "SceneUniforms.h"
+
+#include <cassert>
+#include <new>
+
+SceneUniformBuffer::~SceneUniformBuffer() { Destroy(); }
+
+bool SceneUniformBuffer::Create(int slotCount) {
+  Destroy();
+  if (slotCount <= 0) {
+    return false;
+  }
+
+  // Slots are bound with glBindBufferRange, so each one has to start on the
+  // driver's uniform buffer offset alignment.
+  GLint alignment = 0;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  if (alignment <= 0) {
+    alignment = 256;
+  }
+  const std::size_t align = static_cast<std::size_t>(alignment);
+  slotStride_ = (sizeof(SceneData) + align - 1) / align * align;
+  slotCount_ = slotCount;
+  staging_.assign(slotStride_ * static_cast<std::size_t>(slotCount_), 0);
+  for (int i = 0; i < slotCount_; ++i) {
+    new (staging_.data() + slotStride_ * static_cast<std::size_t>(i))
+        SceneData{};
+  }
+
+  glGenBuffers(1, &buffer_);
+  glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+  glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(staging_.size()),
+               nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  return buffer_ != 0;
+}
+
+void SceneUniformBuffer::Destroy() {
+  if (buffer_) {
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+  staging_.clear();
+  slotStride_ = 0;
+  slotCount_ = 0;
+}
+
+SceneData &SceneUniformBuffer::GetSlot(int slot) {
+  assert(slot >= 0 && slot < slotCount_);
+  return *reinterpret_cast<SceneData *>(
+      staging_.data() + slotStride_ * static_cast<std::size_t>(slot));
+}
+
+void SceneUniformBuffer::Upload() {
+  if (!buffer_) {
+    return;
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0,
+                  static_cast<GLsizeiptr>(staging_.size()), staging_.data());
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void SceneUniformBuffer::Bind(int slot) const {
+  if (!buffer_ || slot < 0 || slot >= slotCount_) {
+    return;
+  }
+  glBindBufferRange(GL_UNIFORM_BUFFER, kSceneDataBinding, buffer_,
+                    static_cast<GLintptr>(slotStride_ *
+                                          static_cast<std::size_t>(slot)),
+                    static_cast<GLsizeiptr>(sizeof(SceneData)));
+}
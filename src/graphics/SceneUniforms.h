@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../glad/glad.h"
+
+// Uniform block binding shared by every shader that declares SceneData.
+constexpr GLuint kSceneDataBinding = 0;
+
+// CPU mirror of the std140 SceneData block declared in the shaders. Only
+// mat4 and vec4 members are used so the C++ layout matches std140 without
+// manual padding.
+struct SceneData {
+  float view[16];
+  float proj[16];
+  float lightDirAndAmbient[4]; // xyz = direction towards the light, w = ambient
+  float cameraPos[4];
+  float fogColor[4];
+  float fogParams[4];
+  float fogParams2[4];
+};
+static_assert(sizeof(SceneData) == 208, "SceneData must match std140 layout");
+
+// Engine-owned uniform buffer holding one SceneData slot per view (one per
+// layer). All slots are uploaded with a single call per frame; Bind() then
+// only switches which slot is attached to kSceneDataBinding, so drawing a
+// layer needs no per-shader matrix uploads or name lookups.
+class SceneUniformBuffer {
+public:
+  SceneUniformBuffer() = default;
+  ~SceneUniformBuffer();
+
+  SceneUniformBuffer(const SceneUniformBuffer &) = delete;
+  SceneUniformBuffer &operator=(const SceneUniformBuffer &) = delete;
+
+  bool Create(int slotCount);
+  void Destroy();
+
+  SceneData &GetSlot(int slot);
+
+  // Uploads every slot. Call once per frame after filling them.
+  void Upload();
+  // Attaches the given slot to kSceneDataBinding.
+  void Bind(int slot) const;
+
+private:
+  GLuint buffer_ = 0;
+  std::size_t slotStride_ = 0;
+  int slotCount_ = 0;
+  std::vector<unsigned char> staging_;
+};
@@ -2,8 +2,13 @@
 
 #include <fstream>
 #include <sstream>
+#include <utility>
 #include <windows.h>
 
+#include "GLCapabilities.h"
+#include "GLStateCache.h"
+#include "ProgramCache.h"
+
 namespace {
 void LogMessage(const std::string &message) {
   OutputDebugStringA(message.c_str());
@@ -19,6 +24,12 @@ Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath) {
     return;
   }
 
+  const std::uint64_t cacheKey = ProgramCache::Get().MakeKey(
+      {"vert", vertexSource, "frag", fragmentSource});
+  if (LoadCachedProgram(cacheKey)) {
+    return;
+  }
+
   GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
   GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
 
@@ -31,10 +42,140 @@ Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath) {
   }
 
   programId_ = glCreateProgram();
-  glAttachShader(programId_, vertexShader);
-  glAttachShader(programId_, fragmentShader);
+  LinkProgram(vertexShader, fragmentShader, cacheKey);
+}
+
+std::unique_ptr<Shader> Shader::CreateAsync(const std::string &vertexPath,
+                                            const std::string &fragmentPath,
+                                            const std::string &defines) {
+  std::unique_ptr<Shader> shader(new Shader());
+  std::string vertexSource = LoadFile(vertexPath);
+  std::string fragmentSource = LoadFile(fragmentPath);
+  if (vertexSource.empty() || fragmentSource.empty()) {
+    LogMessage("Shader source missing or empty.\n");
+    return shader;
+  }
+  if (!defines.empty()) {
+    vertexSource = InjectDefines(vertexSource, defines);
+    fragmentSource = InjectDefines(fragmentSource, defines);
+  }
+
+  const std::uint64_t cacheKey = ProgramCache::Get().MakeKey(
+      {"vert", vertexSource, "frag", fragmentSource});
+  if (shader->LoadCachedProgram(cacheKey)) {
+    return shader;
+  }
+
+  // Compile status is not queried here: that would wait for the compile.
+  // A stage that failed to compile makes the link fail, and its log is
+  // printed when the result is collected in Poll().
+  GLuint vertexShader = SubmitShader(GL_VERTEX_SHADER, vertexSource);
+  GLuint fragmentShader = SubmitShader(GL_FRAGMENT_SHADER, fragmentSource);
+  shader->programId_ = glCreateProgram();
+  shader->BeginLink(vertexShader, fragmentShader, cacheKey);
+  return shader;
+}
+
+std::unique_ptr<Shader> Shader::CreateCompute(const std::string &computePath) {
+  std::unique_ptr<Shader> shader(new Shader());
+  if (!glDispatchCompute) {
+    return shader;
+  }
+
+  const std::string source = LoadFile(computePath);
+  if (source.empty()) {
+    LogMessage("Compute shader source missing or empty.\n");
+    return shader;
+  }
+
+  const std::uint64_t cacheKey = ProgramCache::Get().MakeKey({"comp", source});
+  if (shader->LoadCachedProgram(cacheKey)) {
+    return shader;
+  }
+
+  // Built like CreateAsync: the result is collected in Poll().
+  GLuint computeShader = SubmitShader(GL_COMPUTE_SHADER, source);
+  shader->programId_ = glCreateProgram();
+  shader->BeginLink(computeShader, 0, cacheKey);
+  return shader;
+}
+
+std::unique_ptr<Shader>
+Shader::CreateTransformFeedback(const std::string &vertexPath,
+                                const std::vector<const char *> &varyings) {
+  std::unique_ptr<Shader> shader(new Shader());
+  const std::string source = LoadFile(vertexPath);
+  if (source.empty()) {
+    LogMessage("Transform feedback shader source missing or empty.\n");
+    return shader;
+  }
+
+  // Varyings are baked into the linked program, so they are part of the key.
+  std::vector<std::string> keyInputs = {"xfb", source};
+  keyInputs.insert(keyInputs.end(), varyings.begin(), varyings.end());
+  const std::uint64_t cacheKey = ProgramCache::Get().MakeKey(keyInputs);
+  if (shader->LoadCachedProgram(cacheKey)) {
+    return shader;
+  }
+
+  GLuint vertexShader = SubmitShader(GL_VERTEX_SHADER, source);
+  shader->programId_ = glCreateProgram();
+  glTransformFeedbackVaryings(shader->programId_,
+                              static_cast<GLsizei>(varyings.size()),
+                              varyings.data(), GL_INTERLEAVED_ATTRIBS);
+  shader->BeginLink(vertexShader, 0, cacheKey);
+  return shader;
+}
+
+// Creates programId_ from the binary cache. On a miss or a rejected binary,
+// returns false with programId_ left at 0 so the caller compiles from source.
+bool Shader::LoadCachedProgram(std::uint64_t cacheKey) {
+  const ProgramCache &cache = ProgramCache::Get();
+  if (!cache.IsEnabled()) {
+    return false;
+  }
+
+  programId_ = glCreateProgram();
+  if (cache.Load(programId_, cacheKey)) {
+    CacheUniformLocations();
+    return true;
+  }
+  glDeleteProgram(programId_);
+  programId_ = 0;
+  return false;
+}
+
+// Links the compiled stages into programId_ and collects the result
+// immediately. On failure the program is deleted and programId_ reset to 0;
+// on success the binary is written to the program cache under cacheKey.
+bool Shader::LinkProgram(GLuint firstShader, GLuint secondShader,
+                         std::uint64_t cacheKey) {
+  BeginLink(firstShader, secondShader, cacheKey);
+  return FinishLink();
+}
+
+// Attaches the stages and issues the link without reading any status back.
+// The stages stay alive until FinishLink() so their logs can be read.
+void Shader::BeginLink(GLuint firstShader, GLuint secondShader,
+                       std::uint64_t cacheKey) {
+  if (ProgramCache::Get().IsEnabled()) {
+    glProgramParameteri(programId_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                        GL_TRUE);
+  }
+  glAttachShader(programId_, firstShader);
+  if (secondShader) {
+    glAttachShader(programId_, secondShader);
+  }
   glLinkProgram(programId_);
 
+  pendingStages_[0] = firstShader;
+  pendingStages_[1] = secondShader;
+  cacheKey_ = cacheKey;
+  pending_ = true;
+}
+
+bool Shader::FinishLink() {
+  pending_ = false;
   LogShaderError(programId_, true, "Program");
 
   GLint linked = GL_FALSE;
@@ -42,57 +183,131 @@ Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath) {
   if (!linked) {
     glDeleteProgram(programId_);
     programId_ = 0;
+  } else {
+    CacheUniformLocations();
+    ProgramCache::Get().Store(programId_, cacheKey_);
+  }
+
+  for (GLuint &stage : pendingStages_) {
+    if (stage) {
+      glDeleteShader(stage);
+      stage = 0;
+    }
   }
+  return programId_ != 0;
+}
 
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+bool Shader::Poll() {
+  if (!pending_) {
+    return true;
+  }
+  if (GLCapabilities::Get().SupportsParallelShaderCompile()) {
+    GLint complete = GL_FALSE;
+    glGetProgramiv(programId_, GL_COMPLETION_STATUS_KHR, &complete);
+    if (!complete) {
+      return false;
+    }
+  }
+  // Without the extension this is where the wait happens.
+  LogShaderError(pendingStages_[0], false, "Deferred stage");
+  if (pendingStages_[1]) {
+    LogShaderError(pendingStages_[1], false, "Deferred stage");
+  }
+  FinishLink();
+  return true;
 }
 
 Shader::~Shader() {
+  for (GLuint stage : pendingStages_) {
+    if (stage) {
+      glDeleteShader(stage);
+    }
+  }
   if (programId_) {
+    GLStateCache::Get().OnProgramDeleted(programId_);
     glDeleteProgram(programId_);
   }
 }
 
-bool Shader::IsValid() const { return programId_ != 0; }
+bool Shader::IsValid() const { return programId_ != 0 && !pending_; }
 
-void Shader::Use() const { glUseProgram(programId_); }
+void Shader::Use() const { GLStateCache::Get().UseProgram(programId_); }
 
-void Shader::SetMat4(const std::string &name, const float *value) const {
-  GLint location = glGetUniformLocation(programId_, name.c_str());
+void Shader::SetMat4(const char *name, const float *value) const {
+  GLint location = GetUniformLocation(name);
   if (location >= 0) {
     glUniformMatrix4fv(location, 1, GL_FALSE, value);
   }
 }
 
-void Shader::SetVec2(const std::string &name, float x, float y) const {
-  GLint location = glGetUniformLocation(programId_, name.c_str());
+void Shader::SetVec2(const char *name, float x, float y) const {
+  GLint location = GetUniformLocation(name);
   if (location >= 0) {
     glUniform2f(location, x, y);
   }
 }
 
-void Shader::SetVec3(const std::string &name, float x, float y, float z) const {
-  GLint location = glGetUniformLocation(programId_, name.c_str());
+void Shader::SetVec3(const char *name, float x, float y, float z) const {
+  GLint location = GetUniformLocation(name);
   if (location >= 0) {
     glUniform3f(location, x, y, z);
   }
 }
 
-void Shader::SetFloat(const std::string &name, float value) const {
-  GLint location = glGetUniformLocation(programId_, name.c_str());
+void Shader::SetFloat(const char *name, float value) const {
+  GLint location = GetUniformLocation(name);
   if (location >= 0) {
     glUniform1f(location, value);
   }
 }
 
-void Shader::SetInt(const std::string &name, int value) const {
-  GLint location = glGetUniformLocation(programId_, name.c_str());
+void Shader::SetInt(const char *name, int value) const {
+  GLint location = GetUniformLocation(name);
   if (location >= 0) {
     glUniform1i(location, value);
   }
 }
 
+GLint Shader::GetUniformLocation(const char *name) const {
+  auto it = uniformLocations_.find(name);
+  return it != uniformLocations_.end() ? it->second : -1;
+}
+
+// Records the location of every active uniform. Members of uniform blocks
+// report -1 and are skipped. Arrays are reported as "name[0]" and are also
+// stored under the bare name, matching what glGetUniformLocation accepts.
+void Shader::CacheUniformLocations() {
+  uniformLocations_.clear();
+
+  GLint count = 0;
+  GLint maxLength = 0;
+  glGetProgramiv(programId_, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(programId_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  if (count <= 0 || maxLength <= 0) {
+    return;
+  }
+
+  std::string name(static_cast<size_t>(maxLength), '\0');
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(programId_, static_cast<GLuint>(i), maxLength, &length,
+                       &size, &type, name.data());
+    std::string uniformName(name.data(), static_cast<size_t>(length));
+
+    GLint location = glGetUniformLocation(programId_, uniformName.c_str());
+    if (location < 0) {
+      continue;
+    }
+    const std::string::size_type bracket = uniformName.find('[');
+    if (bracket != std::string::npos) {
+      uniformLocations_.emplace(uniformName.substr(0, bracket), location);
+    }
+    uniformLocations_.emplace(std::move(uniformName), location);
+  }
+}
+
 void Shader::BindUniformBlock(const std::string &name, GLuint binding) const {
   GLuint index = glGetUniformBlockIndex(programId_, name.c_str());
   if (index != GL_INVALID_INDEX) {
@@ -112,13 +327,43 @@ std::string Shader::LoadFile(const std::string &path) {
   return buffer.str();
 }
 
-GLuint Shader::CompileShader(GLenum type, const std::string &source) {
+// #version must stay the first directive, so the defines go on the line
+// after it (or at the top if the source has no #version).
+std::string Shader::InjectDefines(const std::string &source,
+                                  const std::string &defines) {
+  std::string::size_type insertAt = 0;
+  const std::string::size_type version = source.find("#version");
+  if (version != std::string::npos) {
+    const std::string::size_type lineEnd = source.find('\n', version);
+    insertAt = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+  }
+  std::string result = source.substr(0, insertAt);
+  if (insertAt == source.size() && !result.empty() && result.back() != '\n') {
+    result += '\n';
+  }
+  result += defines;
+  result.append(source, insertAt, std::string::npos);
+  return result;
+}
+
+GLuint Shader::SubmitShader(GLenum type, const std::string &source) {
   GLuint shader = glCreateShader(type);
   const char *src = source.c_str();
   glShaderSource(shader, 1, &src, nullptr);
   glCompileShader(shader);
+  return shader;
+}
+
+GLuint Shader::CompileShader(GLenum type, const std::string &source) {
+  GLuint shader = SubmitShader(type, source);
 
-  LogShaderError(shader, false, type == GL_VERTEX_SHADER ? "Vertex" : "Fragment");
+  const char *label = "Fragment";
+  if (type == GL_VERTEX_SHADER) {
+    label = "Vertex";
+  } else if (type == GL_COMPUTE_SHADER) {
+    label = "Compute";
+  }
+  LogShaderError(shader, false, label);
 
   GLint compiled = GL_FALSE;
   glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "../engine/Math.h"
 #include "../glad/glad.h"
 
 class Shader {
@@ -9,21 +15,115 @@ public:
   Shader(const std::string &vertexPath, const std::string &fragmentPath);
   ~Shader();
 
+  Shader(const Shader &) = delete;
+  Shader &operator=(const Shader &) = delete;
+
+  // Issues the compile and link without waiting for either. The program is
+  // not usable (IsValid() is false) until Poll() has returned true. With
+  // KHR_parallel_shader_compile Poll() never blocks; without it the first
+  // Poll() waits for the driver. `defines` (lines such as "#define FX_GLOW
+  // 1\n") is inserted after the #version line of both stages.
+  static std::unique_ptr<Shader> CreateAsync(const std::string &vertexPath,
+                                             const std::string &fragmentPath,
+                                             const std::string &defines = {});
+  // Compute-only program (GL 4.3+). Like CreateAsync, usable after Poll().
+  static std::unique_ptr<Shader> CreateCompute(const std::string &computePath);
+  // Vertex-only program whose outputs are captured with interleaved transform
+  // feedback, in the order given by `varyings`. Usable after Poll().
+  static std::unique_ptr<Shader>
+  CreateTransformFeedback(const std::string &vertexPath,
+                          const std::vector<const char *> &varyings);
+
+  // Collects a pending build. Returns true once the build has finished,
+  // successfully or not; check IsValid() afterwards.
+  bool Poll();
+  bool IsPending() const { return pending_; }
   bool IsValid() const;
   void Use() const;
-  void SetMat4(const std::string &name, const float *value) const;
-  void SetVec2(const std::string &name, float x, float y) const;
-  void SetVec3(const std::string &name, float x, float y, float z) const;
-  void SetFloat(const std::string &name, float value) const;
-  void SetInt(const std::string &name, int value) const;
+  // Name-based setters look the location up in the table built at link time,
+  // so they never call into the driver for the lookup. Hot paths should
+  // prefer a Uniform<T> handle resolved once.
+  void SetMat4(const char *name, const float *value) const;
+  void SetVec2(const char *name, float x, float y) const;
+  void SetVec3(const char *name, float x, float y, float z) const;
+  void SetFloat(const char *name, float value) const;
+  void SetInt(const char *name, int value) const;
   void BindUniformBlock(const std::string &name, GLuint binding) const;
   GLuint GetId() const { return programId_; }
 
+  // Location of an active default-block uniform, or -1 if the program has no
+  // such uniform (including ones the linker optimized away).
+  GLint GetUniformLocation(const char *name) const;
+
 private:
+  Shader() = default;
+
   GLuint programId_ = 0;
+  // Filled from glGetActiveUniform after a successful link. The transparent
+  // comparator lets lookups take a const char * without building a string.
+  std::map<std::string, GLint, std::less<>> uniformLocations_;
+
+  // Stages compiled but not yet collected by FinishLink().
+  GLuint pendingStages_[2] = {0, 0};
+  std::uint64_t cacheKey_ = 0;
+  bool pending_ = false;
+
+  bool LinkProgram(GLuint firstShader, GLuint secondShader,
+                   std::uint64_t cacheKey);
+  void BeginLink(GLuint firstShader, GLuint secondShader,
+                 std::uint64_t cacheKey);
+  bool FinishLink();
+  bool LoadCachedProgram(std::uint64_t cacheKey);
+  void CacheUniformLocations();
 
   static std::string LoadFile(const std::string &path);
+  static std::string InjectDefines(const std::string &source,
+                                   const std::string &defines);
+  static GLuint SubmitShader(GLenum type, const std::string &source);
   static GLuint CompileShader(GLenum type, const std::string &source);
   static void LogShaderError(GLuint id, bool isProgram,
                              const std::string &label);
 };
+
+// Uniform location resolved once against a program, with a typed Set(). The
+// program it was resolved against must be current when Set() is called.
+// Setting an unresolved handle (location -1) is a no-op, like the name-based
+// setters.
+template <typename T> class Uniform {
+public:
+  Uniform() = default;
+  Uniform(const Shader &shader, const char *name)
+      : location_(shader.GetUniformLocation(name)) {}
+
+  bool IsValid() const { return location_ >= 0; }
+  GLint GetLocation() const { return location_; }
+
+  void Set(const T &value) const;
+
+private:
+  GLint location_ = -1;
+};
+
+template <> inline void Uniform<int>::Set(const int &value) const {
+  if (location_ >= 0) {
+    glUniform1i(location_, value);
+  }
+}
+
+template <> inline void Uniform<float>::Set(const float &value) const {
+  if (location_ >= 0) {
+    glUniform1f(location_, value);
+  }
+}
+
+template <> inline void Uniform<Vec3>::Set(const Vec3 &value) const {
+  if (location_ >= 0) {
+    glUniform3f(location_, value.x, value.y, value.z);
+  }
+}
+
+template <> inline void Uniform<Mat4>::Set(const Mat4 &value) const {
+  if (location_ >= 0) {
+    glUniformMatrix4fv(location_, 1, GL_FALSE, value.m.data());
+  }
+}
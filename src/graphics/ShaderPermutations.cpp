@@ -0,0 +1,42 @@
+#include "ShaderPermutations.h"
+
+#include <utility>
+
+#include "../Logger.h"
+
+ShaderPermutationCache::ShaderPermutationCache(
+    std::string vertexPath, std::string fragmentPath,
+    std::vector<std::string> featureDefines)
+    : vertexPath_(std::move(vertexPath)),
+      fragmentPath_(std::move(fragmentPath)),
+      featureDefines_(std::move(featureDefines)) {}
+
+Shader *ShaderPermutationCache::Get(std::uint32_t mask) {
+  auto it = variants_.find(mask);
+  if (it == variants_.end()) {
+    Logger::LogS("Building shader permutation " + fragmentPath_ +
+                 " (mask " + std::to_string(mask) + ")");
+    it = variants_
+             .emplace(mask, Shader::CreateAsync(vertexPath_, fragmentPath_,
+                                                BuildDefines(mask)))
+             .first;
+  }
+
+  Shader *shader = it->second.get();
+  if (!shader->Poll() || !shader->IsValid()) {
+    return nullptr;
+  }
+  return shader;
+}
+
+void ShaderPermutationCache::Clear() { variants_.clear(); }
+
+std::string ShaderPermutationCache::BuildDefines(std::uint32_t mask) const {
+  std::string defines;
+  for (std::size_t i = 0; i < featureDefines_.size() && i < 32; ++i) {
+    if (mask & (1u << i)) {
+      defines += "#define " + featureDefines_[i] + " 1\n";
+    }
+  }
+  return defines;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+
+// Lazily built variants of one vertex/fragment pair, keyed by a feature
+// bitmask. Bit i of the mask adds "#define <featureDefines[i]> 1" to both
+// stages, so each variant contains only the code paths it needs.
+//
+// A variant is submitted the first time it is requested and built with
+// Shader::CreateAsync; Get() returns nullptr until it is usable, and keeps
+// returning nullptr for a variant that failed to build. Callers draw a
+// cheaper fallback in the meantime.
+class ShaderPermutationCache {
+public:
+  ShaderPermutationCache(std::string vertexPath, std::string fragmentPath,
+                         std::vector<std::string> featureDefines);
+
+  ShaderPermutationCache(const ShaderPermutationCache &) = delete;
+  ShaderPermutationCache &operator=(const ShaderPermutationCache &) = delete;
+
+  Shader *Get(std::uint32_t mask);
+
+  // Destroys every variant. Must be called while the context is current.
+  void Clear();
+
+  std::size_t GetVariantCount() const { return variants_.size(); }
+
+private:
+  std::string BuildDefines(std::uint32_t mask) const;
+
+  std::string vertexPath_;
+  std::string fragmentPath_;
+  std::vector<std::string> featureDefines_;
+  std::unordered_map<std::uint32_t, std::unique_ptr<Shader>> variants_;
+};
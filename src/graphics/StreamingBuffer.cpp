@@ -0,0 +1,152 @@
+#include "StreamingBuffer.h"
+
+#include <algorithm>
+
+#include "../Logger.h"
+#include "GLCapabilities.h"
+
+namespace {
+// One second; a region still busy after that means the GPU is hung and
+// blocking longer would not help, so the frame's write is skipped instead.
+constexpr GLuint64 kFenceTimeoutNs = 1000000000ull;
+} // namespace
+
+StreamingBuffer::~StreamingBuffer() { Destroy(); }
+
+bool StreamingBuffer::Create(GLenum target, std::size_t regionSize,
+                             int regionCount) {
+  Destroy();
+  if (regionSize == 0) {
+    return false;
+  }
+
+  target_ = target;
+  regionSize_ = regionSize;
+  persistent_ = GLCapabilities::Get().SupportsBufferStorage();
+  regionCount_ = persistent_ ? std::clamp(regionCount, 1, kMaxRegions) : 1;
+  current_ = regionCount_ - 1;
+
+  glGenBuffers(1, &buffer_);
+  glBindBuffer(target_, buffer_);
+
+  const GLsizeiptr totalSize =
+      static_cast<GLsizeiptr>(regionSize_ * static_cast<std::size_t>(regionCount_));
+  if (persistent_) {
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(target_, totalSize, nullptr, flags);
+    persistentPtr_ = static_cast<unsigned char *>(
+        glMapBufferRange(target_, 0, totalSize, flags));
+    if (!persistentPtr_) {
+      // Fall back to orphaning on drivers that advertise storage but refuse
+      // the persistent map.
+      glDeleteBuffers(1, &buffer_);
+      glGenBuffers(1, &buffer_);
+      glBindBuffer(target_, buffer_);
+      persistent_ = false;
+      regionCount_ = 1;
+      current_ = 0;
+    }
+  }
+  if (!persistent_) {
+    glBufferData(target_, static_cast<GLsizeiptr>(regionSize_), nullptr,
+                 GL_STREAM_DRAW);
+  }
+
+  glBindBuffer(target_, 0);
+  return true;
+}
+
+void StreamingBuffer::Destroy() {
+  for (GLsync &fence : fences_) {
+    if (fence) {
+      glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  if (buffer_) {
+    if (persistentPtr_ || mapped_) {
+      glBindBuffer(target_, buffer_);
+      glUnmapBuffer(target_);
+      glBindBuffer(target_, 0);
+    }
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+  persistentPtr_ = nullptr;
+  mapped_ = false;
+  regionSize_ = 0;
+  current_ = 0;
+}
+
+bool StreamingBuffer::WaitForRegion(int region) {
+  GLsync &fence = fences_[region];
+  if (!fence) {
+    return true;
+  }
+  // The flush makes sure the fence has been submitted, or the wait could
+  // never end.
+  const GLenum result =
+      glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+  if (result == GL_TIMEOUT_EXPIRED) {
+    if (!loggedTimeout_) {
+      Logger::LogS("StreamingBuffer: region still busy after 1 s, skipping "
+                   "writes until it frees up");
+      loggedTimeout_ = true;
+    }
+    // Drop the fence so the next frame does not stall another second on it.
+    glDeleteSync(fence);
+    fence = nullptr;
+    return false;
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+  return true;
+}
+
+void *StreamingBuffer::BeginWrite() {
+  if (!buffer_) {
+    return nullptr;
+  }
+
+  glBindBuffer(target_, buffer_);
+  if (persistent_) {
+    // If the next region never frees up, stay on the current one: the frame
+    // draws last frame's data again rather than hanging on a stuck GPU.
+    const int next = (current_ + 1) % regionCount_;
+    if (!WaitForRegion(next)) {
+      return nullptr;
+    }
+    current_ = next;
+    return persistentPtr_ + GetRegionOffset();
+  }
+
+  // Orphan: the driver detaches the old storage (still in use by queued
+  // draws) and hands back fresh memory without a sync point.
+  glBufferData(target_, static_cast<GLsizeiptr>(regionSize_), nullptr,
+               GL_STREAM_DRAW);
+  void *ptr = glMapBufferRange(target_, 0,
+                               static_cast<GLsizeiptr>(regionSize_),
+                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  mapped_ = (ptr != nullptr);
+  return ptr;
+}
+
+void StreamingBuffer::EndWrite() {
+  if (mapped_) {
+    glBindBuffer(target_, buffer_);
+    glUnmapBuffer(target_);
+    mapped_ = false;
+  }
+}
+
+void StreamingBuffer::Fence() {
+  if (!persistent_) {
+    return;
+  }
+  GLsync &fence = fences_[current_];
+  if (fence) {
+    glDeleteSync(fence);
+  }
+  fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
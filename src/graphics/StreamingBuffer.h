@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../glad/glad.h"
+
+// Per-frame vertex/instance upload buffer.
+//
+// With buffer storage available the buffer is allocated once, mapped
+// persistently and coherently, and split into a ring of regions. Each frame
+// the producer writes straight into the next region through the pointer
+// returned by BeginWrite(); a fence placed after the draw that consumed a
+// region keeps the CPU from overwriting it until the GPU is done. Older
+// drivers get a single region that is orphaned and re-mapped every frame,
+// which lets the driver hand out fresh storage instead of stalling.
+//
+// Region offsets are multiples of the region size, so callers that size
+// regions in whole vertices can draw with a base vertex of
+// GetRegionOffset() / stride.
+class StreamingBuffer {
+public:
+  static constexpr int kDefaultRegionCount = 3;
+
+  StreamingBuffer() = default;
+  ~StreamingBuffer();
+
+  StreamingBuffer(const StreamingBuffer &) = delete;
+  StreamingBuffer &operator=(const StreamingBuffer &) = delete;
+
+  // (Re)creates the buffer. Any previous storage is released first.
+  bool Create(GLenum target, std::size_t regionSize,
+              int regionCount = kDefaultRegionCount);
+  void Destroy();
+
+  // Advances to the next region and returns a write-only pointer to it, or
+  // nullptr on failure. Leaves the buffer bound to its target. If the GPU
+  // still holds the next region after a second, returns nullptr and keeps
+  // the current region, so the caller skips the write and draws the
+  // previous data.
+  void *BeginWrite();
+  // Finishes the writes started by BeginWrite().
+  void EndWrite();
+  // Call after the draw that reads the current region has been issued.
+  void Fence();
+
+  GLuint GetBuffer() const { return buffer_; }
+  std::size_t GetRegionOffset() const { return current_ * regionSize_; }
+  std::size_t GetRegionSize() const { return regionSize_; }
+  bool IsPersistent() const { return persistent_; }
+
+private:
+  static constexpr int kMaxRegions = 4;
+
+  // False if the region's fence did not signal within the timeout. The
+  // fence is deleted either way, so a hung GPU costs one timeout.
+  bool WaitForRegion(int region);
+
+  GLenum target_ = GL_ARRAY_BUFFER;
+  GLuint buffer_ = 0;
+  std::size_t regionSize_ = 0;
+  int regionCount_ = 1;
+  int current_ = 0;
+  bool persistent_ = false;
+  bool mapped_ = false;
+  bool loggedTimeout_ = false;
+  unsigned char *persistentPtr_ = nullptr;
+  GLsync fences_[kMaxRegions] = {};
+};
@@ -1,5 +1,7 @@
 #include "Texture.h"
 
+#include "GLStateCache.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -45,7 +47,7 @@ GLuint Texture::LoadCubeMap(const std::array<std::string, 6> &faces,
                             bool flipVertical) {
   GLuint textureId = 0;
   glGenTextures(1, &textureId);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, textureId);
+  GLStateCache::Get().BindTexture(0, GL_TEXTURE_CUBE_MAP, textureId);
 
   stbi_set_flip_vertically_on_load(flipVertical ? 1 : 0);
 
@@ -77,7 +79,7 @@ GLuint Texture::LoadCubeMap(const std::array<std::string, 6> &faces,
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+  GLStateCache::Get().BindTexture(0, GL_TEXTURE_CUBE_MAP, 0);
 
   return textureId;
 }
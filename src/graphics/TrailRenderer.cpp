@@ -0,0 +1,113 @@
+#include "TrailRenderer.h"
+
+#include "GLStateCache.h"
+
+namespace {
+const char *const kVertexPath = "assets/shaders/fullscreen.vert";
+const char *const kFragmentPath = "assets/shaders/trails.frag";
+} // namespace
+
+bool TrailRenderer::Initialize() {
+  accumulateShader_ = Shader::CreateAsync(kVertexPath, kFragmentPath);
+  applyShader_ = Shader::CreateAsync(kVertexPath, kFragmentPath,
+                                     "#define TRAILS_APPLY 1\n");
+  ready_ = false;
+
+  quad_ = CreateFullscreenQuadMesh();
+  return true;
+}
+
+void TrailRenderer::Cleanup() {
+  DestroyMesh(quad_);
+  accumulateShader_.reset();
+  applyShader_.reset();
+  ready_ = false;
+}
+
+void TrailRenderer::AddPass(FrameGraph &graph, VisualizerLayer &layer,
+                            FrameGraphResource target) {
+  const FrameGraphResource history =
+      graph.Import("TrailHistory", layer.GetTrailHistory());
+  const FrameGraphResource next =
+      graph.Import("Trail", layer.GetTrailTarget());
+  if (history == kInvalidFrameGraphResource ||
+      next == kInvalidFrameGraphResource) {
+    return;
+  }
+
+  VisualizerLayer *layerPtr = &layer;
+  graph.AddPass(
+      "Trails",
+      [&](FrameGraph::Builder &builder) {
+        builder.Read(target);
+        builder.Read(history);
+        builder.Write(next);
+        builder.Write(target);
+      },
+      [this, layerPtr, target, history, next](const FrameGraph &g) {
+        Execute(g, *layerPtr, target, history, next);
+      });
+}
+
+// Collects both programs once their builds have finished.
+bool TrailRenderer::IsReady() {
+  if (ready_) {
+    return true;
+  }
+  if (!accumulateShader_ || !accumulateShader_->Poll() ||
+      !accumulateShader_->IsValid() || !applyShader_ ||
+      !applyShader_->Poll() || !applyShader_->IsValid()) {
+    return false;
+  }
+  // Sampler units never change, so they are set once here.
+  accumulateShader_->Use();
+  accumulateShader_->SetInt("uSource", 0);
+  accumulateShader_->SetInt("uHistory", 1);
+  fadeUniform_ = Uniform<float>(*accumulateShader_, "uFade");
+  applyShader_->Use();
+  applyShader_->SetInt("uSource", 0);
+  ready_ = true;
+  return true;
+}
+
+void TrailRenderer::Execute(const FrameGraph &graph, VisualizerLayer &layer,
+                            FrameGraphResource target,
+                            FrameGraphResource history,
+                            FrameGraphResource next) {
+  if (!IsReady()) {
+    return;
+  }
+  const RenderTarget &layerTarget = *graph.GetTarget(target);
+  const RenderTarget &historyTarget = *graph.GetTarget(history);
+  const RenderTarget &nextTarget = *graph.GetTarget(next);
+
+  GLStateCache &gl = GLStateCache::Get();
+  gl.SetDepthTest(false);
+  gl.SetBlend(false);
+
+  // Pooled targets come back with undefined contents.
+  if (!layer.HasTrailHistory()) {
+    gl.BindFramebuffer(historyTarget.fbo);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+  }
+
+  gl.BindFramebuffer(nextTarget.fbo);
+  gl.Viewport(0, 0, nextTarget.desc.width, nextTarget.desc.height);
+  accumulateShader_->Use();
+  fadeUniform_.Set(TrailFadeOver(layer.GetFXConfig().trailsFade, frameTime_));
+  gl.BindTexture(0, GL_TEXTURE_2D, layerTarget.colorTex);
+  gl.BindTexture(1, GL_TEXTURE_2D, historyTarget.colorTex);
+  DrawMesh(quad_);
+
+  gl.BindFramebuffer(layerTarget.fbo);
+  gl.Viewport(0, 0, layerTarget.desc.width, layerTarget.desc.height);
+  gl.SetBlend(true);
+  gl.BlendEquation(GL_MAX);
+  applyShader_->Use();
+  gl.BindTexture(0, GL_TEXTURE_2D, nextTarget.colorTex);
+  DrawMesh(quad_);
+  gl.BlendEquation(GL_FUNC_ADD);
+
+  layer.SwapTrails();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+
+#include "FrameGraph.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "VisualizerLayer.h"
+
+// Trail/persistence effect for layers with trails enabled. Each layer keeps
+// two half-resolution R11F_G11F_B10F history targets and uses them in turn:
+// a pass writes max(layer, history * fade) into one while reading last
+// frame's from the other, then max-blends the new history onto the layer.
+// The fade is trailsFade scaled to the frame time (TrailFadeOver).
+// Against a full-size RGBA16F history that is an eighth of the memory and
+// of the bytes read and written per frame.
+//
+// Layers whose fade is too low to leave a visible trail do not get the
+// Trails FX bit (see GetFXMask), so they hold no history and get no pass.
+class TrailRenderer {
+public:
+  TrailRenderer() = default;
+  ~TrailRenderer() { Cleanup(); }
+
+  TrailRenderer(const TrailRenderer &) = delete;
+  TrailRenderer &operator=(const TrailRenderer &) = delete;
+
+  // Issues the shader builds; until they finish, passes do nothing.
+  bool Initialize();
+  void Cleanup();
+
+  // Time since the previous frame, in seconds; sets this frame's fade.
+  void SetFrameTime(float seconds) { frameTime_ = seconds; }
+
+  // Adds the trail pass of `layer`, whose target was imported as `target`.
+  // No-op if the layer holds no trail history.
+  void AddPass(FrameGraph &graph, VisualizerLayer &layer,
+               FrameGraphResource target);
+
+private:
+  bool IsReady();
+  void Execute(const FrameGraph &graph, VisualizerLayer &layer,
+               FrameGraphResource target, FrameGraphResource history,
+               FrameGraphResource next);
+
+  std::unique_ptr<Shader> accumulateShader_;
+  std::unique_ptr<Shader> applyShader_;
+  Uniform<float> fadeUniform_;
+  float frameTime_ = 1.0f / kTrailFadeReferenceHz;
+  bool ready_ = false;
+  Mesh quad_{};
+};
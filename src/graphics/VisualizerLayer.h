@@ -2,11 +2,26 @@
 
 #include "../glad/glad.h"
 #include "../visualizers/IVisualizer.h"
+#include "GLStateCache.h"
 #include "PostProcessConfig.h"
+#include "RenderTargetPool.h"
+#include <algorithm>
 #include <memory>
 
+// Screen area a layer covers, in pixels, in GL window coordinates.
+struct LayerRect {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+
+  bool IsEmpty() const { return width <= 0 || height <= 0; }
+};
+
 // VisualizerLayer - encapsulates a visualizer with its own render target and FX
-// Each metric (CPU, RAM, Disk, Network) gets its own layer
+// Each metric (CPU, RAM, Disk, Network) gets its own layer. The targets are
+// only as large as the layer's transformed viewport; the compositor places
+// them on screen with GetRect().
 class VisualizerLayer {
 public:
   VisualizerLayer() = default;
@@ -24,42 +39,81 @@ public:
   VisualizerLayer &operator=(VisualizerLayer &&other) noexcept {
     if (this != &other) {
       Cleanup();
-      m_fbo = other.m_fbo;
-      m_colorTex = other.m_colorTex;
-      m_depthTex = other.m_depthTex;
-      m_trailFbo = other.m_trailFbo;
-      m_trailTex = other.m_trailTex;
+      m_target = other.m_target;
+      m_trail[0] = other.m_trail[0];
+      m_trail[1] = other.m_trail[1];
+      m_trailWrite = other.m_trailWrite;
+      m_trailValid = other.m_trailValid;
       m_width = other.m_width;
       m_height = other.m_height;
+      m_rect = other.m_rect;
       m_visualizer = std::move(other.m_visualizer);
       m_fxConfig = other.m_fxConfig;
       m_name = other.m_name;
 
-      other.m_fbo = 0;
-      other.m_colorTex = 0;
-      other.m_depthTex = 0;
-      other.m_trailFbo = 0;
-      other.m_trailTex = 0;
+      other.m_target = nullptr;
+      other.m_trail[0] = nullptr;
+      other.m_trail[1] = nullptr;
     }
     return *this;
   }
 
-  // Initialize layer with dimensions
-  bool Initialize(int width, int height, const char *name) {
-    m_width = width;
-    m_height = height;
+  // Initialize layer for a screen of the given size
+  bool Initialize(int screenWidth, int screenHeight, const char *name) {
     m_name = name;
-    return CreateFramebuffer(width, height);
+    return Resize(screenWidth, screenHeight);
   }
 
-  // Resize framebuffers when window changes
-  void Resize(int width, int height) {
-    if (width != m_width || height != m_height) {
+  // Re-derives the layer rectangle from the screen size and the current
+  // transform, and acquires or releases targets to match it and the FX
+  // config. Nothing happens unless the size or the trail setting changed,
+  // so this is cheap enough to call every frame. An empty rectangle
+  // releases the targets.
+  bool Resize(int screenWidth, int screenHeight) {
+    m_rect = ComputeRect(m_fxConfig.transform, screenWidth, screenHeight);
+    if (m_rect.width != m_width || m_rect.height != m_height) {
       Cleanup();
-      CreateFramebuffer(width, height);
-      m_width = width;
-      m_height = height;
+      m_width = m_rect.width;
+      m_height = m_rect.height;
     }
+    if (m_rect.IsEmpty()) {
+      return true;
+    }
+
+    RenderTargetPool &pool = RenderTargetPool::Get();
+    if (!m_target) {
+      m_target = pool.Acquire(
+          {m_width, m_height, GL_RGBA16F, GL_DEPTH_COMPONENT24});
+    }
+    // The trail history only exists while the layer has visible trails.
+    const bool trails = (GetFXMask(m_fxConfig) & FXBits::Trails) != 0;
+    if (trails && !m_trail[0]) {
+      const RenderTargetDesc desc{std::max(m_width / kTrailDownscale, 1),
+                                  std::max(m_height / kTrailDownscale, 1),
+                                  GL_R11F_G11F_B10F, 0};
+      m_trail[0] = pool.Acquire(desc);
+      m_trail[1] = pool.Acquire(desc);
+      m_trailWrite = 0;
+      m_trailValid = false;
+    } else if (!trails && m_trail[0]) {
+      ReleaseTrails();
+    }
+    return m_target != nullptr;
+  }
+
+  // LayerTransform measures y down from the top of the screen and places
+  // its anchor point at (x, y); GL window y runs up from the bottom.
+  static LayerRect ComputeRect(const LayerTransform &transform,
+                               int screenWidth, int screenHeight) {
+    const float left = transform.x - transform.anchorX * transform.width;
+    const float top = transform.y - transform.anchorY * transform.height;
+    LayerRect rect;
+    rect.x = static_cast<int>(left * screenWidth);
+    rect.width = static_cast<int>(transform.width * screenWidth);
+    rect.height = static_cast<int>(transform.height * screenHeight);
+    rect.y = screenHeight -
+             static_cast<int>((top + transform.height) * screenHeight);
+    return rect;
   }
 
   // Set the visualizer for this layer
@@ -77,111 +131,71 @@ public:
 
   // Render operations
   void BindForRendering() {
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-    glViewport(0, 0, m_width, m_height);
+    GLStateCache::Get().BindFramebuffer(m_target->fbo);
+    GLStateCache::Get().Viewport(0, 0, m_width, m_height);
+    // glClear honours the depth write mask.
+    GLStateCache::Get().SetDepthMask(true);
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   }
 
-  void Unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+  void Unbind() { GLStateCache::Get().BindFramebuffer(0); }
 
   // Get output texture for compositing
-  GLuint GetColorTexture() const { return m_colorTex; }
-  GLuint GetTrailTexture() const { return m_trailTex; }
-  GLuint GetFBO() const { return m_fbo; }
+  GLuint GetColorTexture() const { return m_target ? m_target->colorTex : 0; }
+  // Trail history, ping-ponged by SwapTrails(): last frame's history is
+  // read while this frame's is written. nullptr unless trails are enabled.
+  RenderTarget *GetTrailHistory() { return m_trail[1 - m_trailWrite]; }
+  RenderTarget *GetTrailTarget() { return m_trail[m_trailWrite]; }
+  // False until a frame has been written since the history was acquired.
+  bool HasTrailHistory() const { return m_trailValid; }
+  void SwapTrails() {
+    m_trailWrite = 1 - m_trailWrite;
+    m_trailValid = true;
+  }
+  GLuint GetFBO() const { return m_target ? m_target->fbo : 0; }
+  RenderTarget *GetTarget() { return m_target; }
 
   // Layer properties
   const char *GetName() const { return m_name; }
   int GetWidth() const { return m_width; }
   int GetHeight() const { return m_height; }
+  const LayerRect &GetRect() const { return m_rect; }
+  bool HasTargets() const { return m_target != nullptr; }
   int GetRenderOrder() const { return m_fxConfig.renderOrder; }
 
-  // Cleanup resources
+  // Returns the targets to the pool
   void Cleanup() {
-    if (m_fbo) {
-      glDeleteFramebuffers(1, &m_fbo);
-      m_fbo = 0;
-    }
-    if (m_colorTex) {
-      glDeleteTextures(1, &m_colorTex);
-      m_colorTex = 0;
-    }
-    if (m_depthTex) {
-      glDeleteTextures(1, &m_depthTex);
-      m_depthTex = 0;
-    }
-    if (m_trailFbo) {
-      glDeleteFramebuffers(1, &m_trailFbo);
-      m_trailFbo = 0;
-    }
-    if (m_trailTex) {
-      glDeleteTextures(1, &m_trailTex);
-      m_trailTex = 0;
-    }
+    RenderTargetPool::Get().Release(m_target);
+    m_target = nullptr;
+    ReleaseTrails();
+    m_width = 0;
+    m_height = 0;
   }
 
 private:
-  bool CreateFramebuffer(int width, int height) {
-    // Main color/depth FBO
-    glGenFramebuffers(1, &m_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-
-    // Color texture (RGBA16F for HDR)
-    glGenTextures(1, &m_colorTex);
-    glBindTexture(GL_TEXTURE_2D, m_colorTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA,
-                 GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                           m_colorTex, 0);
-
-    // Depth texture
-    glGenTextures(1, &m_depthTex);
-    glBindTexture(GL_TEXTURE_2D, m_depthTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0,
-                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
-                           m_depthTex, 0);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-      return false;
-    }
-
-    // Trail buffer for persistence effects
-    glGenFramebuffers(1, &m_trailFbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_trailFbo);
-
-    glGenTextures(1, &m_trailTex);
-    glBindTexture(GL_TEXTURE_2D, m_trailTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA,
-                 GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                           m_trailTex, 0);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    return true;
+  // Trail history is kept at this fraction of the layer size.
+  static constexpr int kTrailDownscale = 2;
+
+  void ReleaseTrails() {
+    RenderTargetPool::Get().Release(m_trail[0]);
+    RenderTargetPool::Get().Release(m_trail[1]);
+    m_trail[0] = nullptr;
+    m_trail[1] = nullptr;
+    m_trailValid = false;
   }
 
-  // OpenGL resources
-  GLuint m_fbo = 0;
-  GLuint m_colorTex = 0;
-  GLuint m_depthTex = 0;
-  GLuint m_trailFbo = 0; // For trail/persistence effects
-  GLuint m_trailTex = 0;
+  // Render targets, owned by the pool while acquired
+  RenderTarget *m_target = nullptr; // Color + depth
+  // Trail/persistence history: half size, R11F_G11F_B10F (no alpha)
+  RenderTarget *m_trail[2] = {nullptr, nullptr};
+  int m_trailWrite = 0; // Index of the target written this frame
+  bool m_trailValid = false;
 
-  // Dimensions
+  // Target dimensions (the size of m_rect)
   int m_width = 0;
   int m_height = 0;
+  LayerRect m_rect;
 
   // Visualizer
   std::unique_ptr<IVisualizer> m_visualizer;
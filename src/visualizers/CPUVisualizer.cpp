@@ -0,0 +1,351 @@
+#include "CPUVisualizer.h"
+
+#include "../engine/SimdMath.h"
+#include "../engine/ThreadPool.h"
+#include <utility>
+
+// CPU height field. Every trig term of the surface is a sine of a column
+// angle plus a row angle, so it is expanded with the angle-sum identity:
+// sin(col + row) = sin(col) cos(row) + cos(col) sin(row). The column sines
+// and cosines are fixed by the grid, the row ones are evaluated once per
+// step, and a vertex is then a handful of multiply-adds. The kernels run
+// over whole SIMD blocks (buffers are padded with RoundUpToLanes) and use
+// the same operations in the same order as their scalar loops.
+
+namespace {
+
+// Rows per ParallelFor chunk: enough work per claim to amortize the shared
+// counter, small enough to balance across cores on the default grids.
+constexpr size_t kRowsPerChunk = 4;
+
+// Per-row coefficients of
+//   y = (c + a sinMacro + b cosMacro + meso + |f1 sinFold + f2 cosFold|)
+//       * (d0 + d1 sinBreath + d2 cosBreath)
+struct RowTerms {
+  float c, a, b;
+  float f1, f2;
+  float d0, d1, d2;
+};
+
+struct ColumnPointers {
+  const float *sinMacro, *cosMacro;
+  const float *sinFold, *cosFold;
+  const float *sinBreath, *cosBreath;
+  const float *meso;
+};
+
+void HeightRow(const RowTerms &t, const ColumnPointers &col, float *out,
+               std::size_t count) {
+  std::size_t x = 0;
+
+#if defined(SCREENSAVER_SIMD_AVX2)
+  const __m256 c = _mm256_set1_ps(t.c);
+  const __m256 a = _mm256_set1_ps(t.a);
+  const __m256 b = _mm256_set1_ps(t.b);
+  const __m256 f1 = _mm256_set1_ps(t.f1);
+  const __m256 f2 = _mm256_set1_ps(t.f2);
+  const __m256 d0 = _mm256_set1_ps(t.d0);
+  const __m256 d1 = _mm256_set1_ps(t.d1);
+  const __m256 d2 = _mm256_set1_ps(t.d2);
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  for (; x + 8 <= count; x += 8) {
+    const __m256 macro =
+        _mm256_add_ps(_mm256_mul_ps(a, _mm256_loadu_ps(col.sinMacro + x)),
+                      _mm256_mul_ps(b, _mm256_loadu_ps(col.cosMacro + x)));
+    const __m256 fold = _mm256_andnot_ps(
+        signMask,
+        _mm256_add_ps(_mm256_mul_ps(f1, _mm256_loadu_ps(col.sinFold + x)),
+                      _mm256_mul_ps(f2, _mm256_loadu_ps(col.cosFold + x))));
+    const __m256 shape = _mm256_add_ps(
+        _mm256_add_ps(_mm256_add_ps(c, macro), _mm256_loadu_ps(col.meso + x)),
+        fold);
+    const __m256 breath = _mm256_add_ps(
+        d0,
+        _mm256_add_ps(_mm256_mul_ps(d1, _mm256_loadu_ps(col.sinBreath + x)),
+                      _mm256_mul_ps(d2, _mm256_loadu_ps(col.cosBreath + x))));
+    _mm256_storeu_ps(out + x, _mm256_mul_ps(shape, breath));
+  }
+#elif defined(SCREENSAVER_SIMD_SSE2)
+  const __m128 c = _mm_set1_ps(t.c);
+  const __m128 a = _mm_set1_ps(t.a);
+  const __m128 b = _mm_set1_ps(t.b);
+  const __m128 f1 = _mm_set1_ps(t.f1);
+  const __m128 f2 = _mm_set1_ps(t.f2);
+  const __m128 d0 = _mm_set1_ps(t.d0);
+  const __m128 d1 = _mm_set1_ps(t.d1);
+  const __m128 d2 = _mm_set1_ps(t.d2);
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  for (; x + 4 <= count; x += 4) {
+    const __m128 macro =
+        _mm_add_ps(_mm_mul_ps(a, _mm_loadu_ps(col.sinMacro + x)),
+                   _mm_mul_ps(b, _mm_loadu_ps(col.cosMacro + x)));
+    const __m128 fold = _mm_andnot_ps(
+        signMask, _mm_add_ps(_mm_mul_ps(f1, _mm_loadu_ps(col.sinFold + x)),
+                             _mm_mul_ps(f2, _mm_loadu_ps(col.cosFold + x))));
+    const __m128 shape = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(c, macro), _mm_loadu_ps(col.meso + x)), fold);
+    const __m128 breath = _mm_add_ps(
+        d0, _mm_add_ps(_mm_mul_ps(d1, _mm_loadu_ps(col.sinBreath + x)),
+                       _mm_mul_ps(d2, _mm_loadu_ps(col.cosBreath + x))));
+    _mm_storeu_ps(out + x, _mm_mul_ps(shape, breath));
+  }
+#endif
+
+  for (; x < count; ++x) {
+    const float macro = t.a * col.sinMacro[x] + t.b * col.cosMacro[x];
+    const float fold = std::fabs(t.f1 * col.sinFold[x] + t.f2 * col.cosFold[x]);
+    const float shape = ((t.c + macro) + col.meso[x]) + fold;
+    const float breath =
+        t.d0 + (t.d1 * col.sinBreath[x] + t.d2 * col.cosBreath[x]);
+    out[x] = shape * breath;
+  }
+}
+
+// Normals of one row from central differences, clamped at the edges like
+// the heights: `center`, `down` and `up` point at the leading guard of
+// their rows, so height x is at index x + 1 and both neighbours exist.
+void NormalRow(const float *center, const float *down, const float *up,
+               float *nx, float *ny, float *nz, std::size_t count) {
+  std::size_t x = 0;
+
+#if defined(SCREENSAVER_SIMD_AVX2)
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  const __m256 four = _mm256_set1_ps(4.0f);
+  for (; x + 8 <= count; x += 8) {
+    const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(center + x),
+                                    _mm256_loadu_ps(center + x + 2));
+    const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(down + x + 1),
+                                    _mm256_loadu_ps(up + x + 1));
+    const __m256 lengthSq = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), four), _mm256_mul_ps(dz, dz));
+    const __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSq));
+    _mm256_storeu_ps(nx + x, _mm256_mul_ps(dx, inv));
+    _mm256_storeu_ps(ny + x, _mm256_mul_ps(two, inv));
+    _mm256_storeu_ps(nz + x, _mm256_mul_ps(dz, inv));
+  }
+#elif defined(SCREENSAVER_SIMD_SSE2)
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 four = _mm_set1_ps(4.0f);
+  for (; x + 4 <= count; x += 4) {
+    const __m128 dx =
+        _mm_sub_ps(_mm_loadu_ps(center + x), _mm_loadu_ps(center + x + 2));
+    const __m128 dz =
+        _mm_sub_ps(_mm_loadu_ps(down + x + 1), _mm_loadu_ps(up + x + 1));
+    const __m128 lengthSq =
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), four), _mm_mul_ps(dz, dz));
+    const __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+    _mm_storeu_ps(nx + x, _mm_mul_ps(dx, inv));
+    _mm_storeu_ps(ny + x, _mm_mul_ps(two, inv));
+    _mm_storeu_ps(nz + x, _mm_mul_ps(dz, inv));
+  }
+#endif
+
+  for (; x < count; ++x) {
+    const float dx = center[x] - center[x + 2];
+    const float dz = down[x + 1] - up[x + 1];
+    const float inv = 1.0f / std::sqrt((dx * dx + 4.0f) + dz * dz);
+    nx[x] = dx * inv;
+    ny[x] = 2.0f * inv;
+    nz[x] = dz * inv;
+  }
+}
+
+} // namespace
+
+// Sizes the scratch buffers for the current grid and fills the column terms
+// that only depend on it. Called from Init, i.e. only when the grid changes.
+void CPUVisualizer::ResizeMeshBuffers() {
+  m_columnCount = Simd::RoundUpToLanes(static_cast<size_t>(m_gridX));
+  m_rowCount = Simd::RoundUpToLanes(static_cast<size_t>(m_gridZ));
+  // Room for the two guards and for NormalRow reading two past a block.
+  m_rowStride = m_columnCount + Simd::kPadLanes;
+  const size_t normalCount = m_columnCount * static_cast<size_t>(m_gridZ);
+  for (MeshStep *step : {&m_mesh, &m_prevMesh}) {
+    step->heights.assign(m_rowStride * static_cast<size_t>(m_gridZ), 0.0f);
+    step->normalX.assign(normalCount, 0.0f);
+    step->normalY.assign(normalCount, 0.0f);
+    step->normalZ.assign(normalCount, 0.0f);
+  }
+
+  MeshColumns &col = m_columns;
+  for (std::vector<float> *column :
+       {&col.pos, &col.centered, &col.sinMacro, &col.cosMacro, &col.sinFold,
+        &col.cosFold, &col.sinBreath, &col.cosBreath, &col.mesoAngle,
+        &col.mesoAmp, &col.meso, &col.scratch}) {
+    column->assign(m_columnCount, 0.0f);
+  }
+  m_rows.angle.assign(m_rowCount * 4, 0.0f);
+  m_rows.sin.assign(m_rowCount * 4, 0.0f);
+  m_rows.cos.assign(m_rowCount * 4, 0.0f);
+
+  // Padding columns run past x = 1; they are computed but never emitted.
+  const float widthStep = 1.0f / static_cast<float>(m_gridX - 1);
+  for (size_t x = 0; x < m_columnCount; ++x) {
+    col.pos[x] = static_cast<float>(x) * widthStep;
+    col.centered[x] = (col.pos[x] - 0.5f) * 2.0f;
+  }
+
+  for (size_t x = 0; x < m_columnCount; ++x) {
+    col.scratch[x] = col.centered[x] * 2.7f;
+  }
+  Simd::SinCos(col.scratch.data(), col.sinMacro.data(), col.cosMacro.data(),
+               m_columnCount);
+  for (size_t x = 0; x < m_columnCount; ++x) {
+    col.scratch[x] = col.centered[x] * 4.2f;
+  }
+  Simd::SinCos(col.scratch.data(), col.sinFold.data(), col.cosFold.data(),
+               m_columnCount);
+  for (size_t x = 0; x < m_columnCount; ++x) {
+    col.scratch[x] = col.pos[x] * 1.8f;
+  }
+  Simd::SinCos(col.scratch.data(), col.sinBreath.data(), col.cosBreath.data(),
+               m_columnCount);
+}
+
+void CPUVisualizer::UpdateMesh() {
+  if (m_mesh.heights.empty()) {
+    return;
+  }
+  // The latest step becomes the previous one and the older buffers are
+  // overwritten in full below.
+  std::swap(m_mesh, m_prevMesh);
+  MeshColumns &col = m_columns;
+
+  // Meso wave: depends on the column and the spectrum only.
+  for (size_t x = 0; x < m_columnCount; ++x) {
+    const float spectrumH = InterpolateSpectrum(col.pos[x]);
+    col.mesoAngle[x] = col.centered[x] * 9.0f + m_mesoPhase + spectrumH * 5.5f;
+    col.mesoAmp[x] = 0.06f + 0.18f * spectrumH;
+  }
+  Simd::SinCos(col.mesoAngle.data(), col.meso.data(), col.scratch.data(),
+               m_columnCount);
+  for (size_t x = 0; x < m_columnCount; ++x) {
+    col.meso[x] *= col.mesoAmp[x];
+  }
+
+  // Row angles, in four blocks evaluated by one SinCos call.
+  const float depthStep = 1.0f / static_cast<float>(m_gridZ - 1);
+  float *macroAngle = m_rows.angle.data();
+  float *foldAngle = macroAngle + m_rowCount;
+  float *breathAngle = foldAngle + m_rowCount;
+  float *macroCosAngle = breathAngle + m_rowCount;
+  for (int z = 0; z < m_gridZ; ++z) {
+    const float zPos = static_cast<float>(z) * depthStep;
+    const float zCentered = (zPos - 0.5f) * 2.0f;
+    macroAngle[z] = zCentered * 1.9f + m_macroPhase;
+    foldAngle[z] = zCentered * 3.0f + m_time * 0.85f;
+    breathAngle[z] = m_time * 0.35f + zPos * 5.2f;
+    macroCosAngle[z] = zCentered * 2.1f - m_macroPhase * 0.8f;
+  }
+  Simd::SinCos(m_rows.angle.data(), m_rows.sin.data(), m_rows.cos.data(),
+               m_rows.angle.size());
+
+  const ColumnPointers columns = {
+      col.sinMacro.data(), col.cosMacro.data(),  col.sinFold.data(),
+      col.cosFold.data(),  col.sinBreath.data(), col.cosBreath.data(),
+      col.meso.data()};
+  const size_t gridX = static_cast<size_t>(m_gridX);
+  const size_t gridZ = static_cast<size_t>(m_gridZ);
+
+  // Rows are independent; the normal pass below reads neighbouring rows, so
+  // it only starts once ParallelFor has returned.
+  ThreadPool &pool = ThreadPool::Get();
+  pool.ParallelFor(gridZ, kRowsPerChunk, [&](size_t first, size_t last) {
+    for (size_t zi = first; zi < last; ++zi) {
+      const float zPos = static_cast<float>(zi) * depthStep;
+      const HistorySample &hist = m_history[zi];
+      const float macroAmp = 0.45f + hist.usage * 0.65f;
+      const float foldAmp = 0.04f + hist.burst * 0.22f;
+      const float depthMask = std::clamp(1.0f - zPos * 0.82f, 0.12f, 1.0f);
+      const size_t macroRow = zi;
+      const size_t foldRow = m_rowCount + macroRow;
+      const size_t breathRow = m_rowCount * 2 + macroRow;
+      const size_t macroCosRow = m_rowCount * 3 + macroRow;
+
+      RowTerms terms;
+      terms.c = std::pow(std::clamp(hist.usage, 0.0f, 1.0f), 1.25f) * 1.55f +
+                m_rows.cos[macroCosRow] * 0.16f * macroAmp;
+      terms.a = 0.20f * macroAmp * m_rows.cos[macroRow];
+      terms.b = 0.20f * macroAmp * m_rows.sin[macroRow];
+      // foldAmp > 0, so it can move inside the absolute value.
+      terms.f1 = foldAmp * m_rows.cos[foldRow];
+      terms.f2 = foldAmp * m_rows.sin[foldRow];
+      terms.d0 = depthMask * 0.92f;
+      terms.d1 = depthMask * 0.18f * m_rows.cos[breathRow];
+      terms.d2 = depthMask * 0.18f * m_rows.sin[breathRow];
+
+      float *row = m_mesh.heights.data() + zi * m_rowStride;
+      HeightRow(terms, columns, row + 1, m_columnCount);
+      row[0] = row[1];
+      row[gridX + 1] = row[gridX];
+    }
+  });
+
+  pool.ParallelFor(gridZ, kRowsPerChunk, [&](size_t first, size_t last) {
+    for (size_t zi = first; zi < last; ++zi) {
+      const int z = static_cast<int>(zi);
+      const int zm = (z > 0) ? z - 1 : z;
+      const int zp = (z + 1 < m_gridZ) ? z + 1 : z;
+      const size_t normalRow = zi * m_columnCount;
+      const float *heights = m_mesh.heights.data();
+      NormalRow(heights + zi * m_rowStride,
+                heights + static_cast<size_t>(zm) * m_rowStride,
+                heights + static_cast<size_t>(zp) * m_rowStride,
+                m_mesh.normalX.data() + normalRow,
+                m_mesh.normalY.data() + normalRow,
+                m_mesh.normalZ.data() + normalRow, m_columnCount);
+    }
+  });
+}
+
+// Writes the surface between the previous and the latest step into the next
+// stream region, so the CPU path moves every frame instead of once per step.
+// Vertices go straight into the mapped (write-combined) region: written
+// once, in order, never read back. Normals are renormalized in
+// cpu_surreal.vert, so they are blended component-wise.
+void CPUVisualizer::WriteBlendedMesh(float alpha) {
+  if (m_mesh.heights.empty()) {
+    return;
+  }
+  float *vertices = static_cast<float *>(m_vertexStream.BeginWrite());
+  if (!vertices)
+    return;
+
+  const MeshColumns &col = m_columns;
+  const float depthStep = 1.0f / static_cast<float>(m_gridZ - 1);
+  const size_t gridX = static_cast<size_t>(m_gridX);
+  ThreadPool::Get().ParallelFor(
+      static_cast<size_t>(m_gridZ), kRowsPerChunk,
+      [&](size_t first, size_t last) {
+        for (size_t zi = first; zi < last; ++zi) {
+          const size_t heightRow = zi * m_rowStride + 1;
+          const size_t normalRow = zi * m_columnCount;
+          const float *h0 = m_prevMesh.heights.data() + heightRow;
+          const float *h1 = m_mesh.heights.data() + heightRow;
+          const float *nx0 = m_prevMesh.normalX.data() + normalRow;
+          const float *ny0 = m_prevMesh.normalY.data() + normalRow;
+          const float *nz0 = m_prevMesh.normalZ.data() + normalRow;
+          const float *nx1 = m_mesh.normalX.data() + normalRow;
+          const float *ny1 = m_mesh.normalY.data() + normalRow;
+          const float *nz1 = m_mesh.normalZ.data() + normalRow;
+
+          const float zPos = static_cast<float>(zi) * depthStep;
+          float *out = vertices + zi * gridX * 8;
+          for (size_t x = 0; x < gridX; ++x, out += 8) {
+            out[0] = col.pos[x];
+            out[1] = Lerp(h0[x], h1[x], alpha);
+            out[2] = zPos;
+            out[3] = Lerp(nx0[x], nx1[x], alpha);
+            out[4] = Lerp(ny0[x], ny1[x], alpha);
+            out[5] = Lerp(nz0[x], nz1[x], alpha);
+            out[6] = col.pos[x];
+            out[7] = zPos;
+          }
+        }
+      });
+
+  m_vertexStream.EndWrite();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
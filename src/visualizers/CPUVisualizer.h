@@ -1,23 +1,35 @@
 #pragma once
 
+#include "../engine/RingBuffer.h"
+#include "../graphics/GLStateCache.h"
 #include "../graphics/Shader.h"
+#include "../graphics/StreamingBuffer.h"
 #include "IVisualizer.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <deque>
 #include <vector>
 
 // CPU Visualization: surreal sci-fi mesh dreamscape.
+//
+// The height field is either rebuilt on the CPU every simulation step
+// (UpdateMesh, blended between the last two steps by WriteBlendedMesh) or, when Draw is handed the GPU_DISPLACEMENT variant of
+// cpu_surreal.vert, evaluated in the vertex shader over a static flat grid.
+// The CPU path stays the fallback for preview mode and for drivers without
+// the displacement shader, so it is vectorized and allocation-free.
+// The GPU path only uploads the usage/burst history (a small RG32F
+// texture) and the spectrum, so its grid can be far finer at no CPU cost.
 class CPUVisualizer : public IVisualizer {
 public:
   explicit CPUVisualizer(const Config &config) : m_config(config) {
     m_gridX = m_config.cpuGridSize;
     m_gridZ = m_config.cpuGridSize;
-    m_history.resize(m_gridZ, 0.0f);
-    m_burstHistory.resize(m_gridZ, 0.0f);
+    m_history.Reset(static_cast<size_t>(m_gridZ));
   }
 
   void Init() override {
+    ResizeMeshBuffers();
+
     m_indices.clear();
     for (int z = 0; z < m_gridZ - 1; ++z) {
       for (int x = 0; x < m_gridX - 1; ++x) {
@@ -40,17 +52,15 @@ public:
 
     if (m_vao == 0)
       glGenVertexArrays(1, &m_vao);
-    if (m_vbo == 0)
-      glGenBuffers(1, &m_vbo);
     if (m_ibo == 0)
       glGenBuffers(1, &m_ibo);
 
-    glBindVertexArray(m_vao);
+    m_vertexStream.Create(GL_ARRAY_BUFFER,
+                          static_cast<size_t>(m_gridX * m_gridZ) * kVertexSize);
+
+    GLStateCache::Get().BindVertexArray(m_vao);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    const size_t vertexSize = (3 + 3 + 2) * sizeof(float);
-    glBufferData(GL_ARRAY_BUFFER, m_gridX * m_gridZ * vertexSize, nullptr,
-                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexStream.GetBuffer());
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float),
@@ -69,18 +79,22 @@ public:
                  m_indices.size() * sizeof(unsigned int), m_indices.data(),
                  GL_STATIC_DRAW);
 
-    glBindVertexArray(0);
+    GLStateCache::Get().BindVertexArray(0);
   }
 
   void Update(float dt, const SystemMonitor &monitor) override {
     if (m_config.cpuGridSize != m_gridX) {
       m_gridX = m_config.cpuGridSize;
       m_gridZ = m_config.cpuGridSize;
-      m_history.assign(m_gridZ, 0.0f);
-      m_burstHistory.assign(m_gridZ, 0.0f);
+      m_history.Reset(static_cast<size_t>(m_gridZ));
+      m_pendingHistoryTexels = m_gridZ;
       Init();
     }
 
+    m_prevTime = m_time;
+    m_prevMacroPhase = m_macroPhase;
+    m_prevMesoPhase = m_mesoPhase;
+
     m_time += dt;
     m_updateTimer += dt;
 
@@ -105,20 +119,22 @@ public:
     if (m_updateTimer > 0.033f) {
       m_updateTimer = 0.0f;
 
-      m_spectrum.resize(10);
-      for (int i = 0; i < 10; ++i) {
+      for (int i = 0; i < kSpectrumBands; ++i) {
         m_spectrum[i] = monitor.GetSpectrumBand(i);
       }
 
-      if (m_history.size() >= static_cast<size_t>(m_gridZ)) {
-        m_history.pop_back();
-      }
-      if (m_burstHistory.size() >= static_cast<size_t>(m_gridZ)) {
-        m_burstHistory.pop_back();
-      }
+      m_history.Push({usage, m_burstEnergy});
+      m_pendingHistoryTexels = std::min(m_pendingHistoryTexels + 1, m_gridZ);
+    }
+
+    m_currentUsageSmoothed =
+        m_currentUsageSmoothed * 0.92f +
+        (m_history.IsEmpty() ? 0.0f : m_history.Newest().usage) * 0.08f;
 
-      m_history.push_front(usage);
-      m_burstHistory.push_front(m_burstEnergy);
+    // Rebuilt once per simulation step rather than once per rendered frame,
+    // and not at all while the shader displaces the grid.
+    if (!m_gpuActive) {
+      UpdateMesh();
     }
   }
 
@@ -126,8 +142,6 @@ public:
     if (!IsEnabled() || !shader)
       return;
 
-    UpdateMesh();
-
     shader->Use();
 
     Mat4 transform = Mat4Translate(-2.0f, m_config.cpuYOffset, 0.0f);
@@ -135,11 +149,31 @@ public:
     Mat4 scale = Mat4Scale(4.2f, 2.2f, 4.2f);
     Mat4 model = Mat4Multiply(transform, scale);
 
-    shader->SetMat4("uModel", model.m.data());
-    shader->SetFloat("uTime", m_time);
-    shader->SetFloat("uEnergy", m_currentUsageSmoothed);
-    shader->SetFloat("uBurst", m_burstEnergy);
-    shader->SetFloat("uPalettePhase", m_macroPhase * 0.35f + m_mesoPhase * 0.2f);
+    if (m_uniforms.program != shader->GetId()) {
+      m_uniforms.program = shader->GetId();
+      m_uniforms.model = Uniform<Mat4>(*shader, "uModel");
+      m_uniforms.time = Uniform<float>(*shader, "uTime");
+      m_uniforms.energy = Uniform<float>(*shader, "uEnergy");
+      m_uniforms.burst = Uniform<float>(*shader, "uBurst");
+      m_uniforms.palettePhase = Uniform<float>(*shader, "uPalettePhase");
+      m_uniforms.color = Uniform<Vec3>(*shader, "uColor");
+      m_uniforms.history = Uniform<int>(*shader, "uHistory");
+      m_uniforms.historyLength = Uniform<float>(*shader, "uHistoryLength");
+      m_uniforms.historyHead = Uniform<float>(*shader, "uHistoryHead");
+      m_uniforms.spectrum = shader->GetUniformLocation("uSpectrum");
+      m_uniforms.macroPhase = Uniform<float>(*shader, "uMacroPhase");
+      m_uniforms.mesoPhase = Uniform<float>(*shader, "uMesoPhase");
+      m_uniforms.normalStep = Uniform<float>(*shader, "uNormalStep");
+    }
+    m_uniforms.model.Set(model);
+    const float time = Lerp(m_prevTime, m_time, m_interpolation);
+    const float macroPhase =
+        Lerp(m_prevMacroPhase, m_macroPhase, m_interpolation);
+    const float mesoPhase = Lerp(m_prevMesoPhase, m_mesoPhase, m_interpolation);
+    m_uniforms.time.Set(time);
+    m_uniforms.energy.Set(m_currentUsageSmoothed);
+    m_uniforms.burst.Set(m_burstEnergy);
+    m_uniforms.palettePhase.Set(macroPhase * 0.35f + mesoPhase * 0.2f);
 
     const float t = std::clamp(0.2f + 0.65f * m_currentUsageSmoothed +
                                    0.15f * m_burstEnergy,
@@ -150,147 +184,220 @@ public:
     r = std::clamp(r, 0.0f, 1.0f);
     g = std::clamp(g, 0.0f, 1.0f);
     b = std::clamp(b, 0.0f, 1.0f);
-    shader->SetVec3("uColor", r, g, b);
+    m_uniforms.color.Set(Vec3{r, g, b});
 
-    glBindVertexArray(m_vao);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()),
-                   GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    // Only the GPU_DISPLACEMENT variant has a history sampler.
+    if (m_uniforms.history.IsValid()) {
+      DrawDisplaced(macroPhase, mesoPhase);
+      return;
+    }
+    if (m_gpuActive) {
+      // Back on the CPU path: the mesh was not kept up to date, and there
+      // is no previous step worth blending from.
+      m_gpuActive = false;
+      UpdateMesh();
+      m_prevMesh = m_mesh;
+    }
+    WriteBlendedMesh(m_interpolation);
+
+    // Regions hold whole grids, so the ring offset is a whole vertex count.
+    const GLint baseVertex =
+        static_cast<GLint>(m_vertexStream.GetRegionOffset() / kVertexSize);
+    GLStateCache::Get().BindVertexArray(m_vao);
+    glDrawElementsBaseVertex(GL_TRIANGLES,
+                             static_cast<GLsizei>(m_indices.size()),
+                             GL_UNSIGNED_INT, nullptr, baseVertex);
+    m_vertexStream.Fence();
   }
 
   void Cleanup() override {
     if (m_vao) {
+      GLStateCache::Get().OnVertexArrayDeleted(m_vao);
       glDeleteVertexArrays(1, &m_vao);
       m_vao = 0;
     }
-    if (m_vbo) {
-      glDeleteBuffers(1, &m_vbo);
-      m_vbo = 0;
-    }
+    m_vertexStream.Destroy();
     if (m_ibo) {
       glDeleteBuffers(1, &m_ibo);
       m_ibo = 0;
     }
+    DestroyDisplacedGrid();
+    if (m_historyTex) {
+      GLStateCache::Get().OnTextureDeleted(m_historyTex);
+      glDeleteTextures(1, &m_historyTex);
+      m_historyTex = 0;
+      m_historyTexLength = 0;
+    }
   }
 
   bool IsEnabled() const override { return m_config.cpuMetric.enabled; }
 
 private:
   float InterpolateSpectrum(float x01) const {
-    if (m_spectrum.empty())
-      return 0.0f;
     const float bandPos = x01 * 9.0f;
     int idx = static_cast<int>(bandPos);
     idx = std::clamp(idx, 0, 9);
     const float frac = bandPos - static_cast<float>(idx);
 
-    const float a = (idx < static_cast<int>(m_spectrum.size())) ? m_spectrum[idx]
-                                                                 : 0.0f;
-    const float b = (idx + 1 < static_cast<int>(m_spectrum.size()))
-                        ? m_spectrum[idx + 1]
-                        : a;
+    const float a = m_spectrum[idx];
+    const float b = (idx + 1 < kSpectrumBands) ? m_spectrum[idx + 1] : a;
     return a * (1.0f - frac) + b * frac;
   }
 
-  void UpdateMesh() {
-    std::vector<float> heights(static_cast<size_t>(m_gridX * m_gridZ), 0.0f);
-    std::vector<float> vertices;
-    vertices.resize(static_cast<size_t>(m_gridX * m_gridZ * 8), 0.0f);
-
-    m_currentUsageSmoothed = m_currentUsageSmoothed * 0.92f +
-                             (m_history.empty() ? 0.0f : m_history.front()) * 0.08f;
-
-    const float widthStep = 1.0f / static_cast<float>(m_gridX - 1);
-    const float depthStep = 1.0f / static_cast<float>(m_gridZ - 1);
-
-    for (int z = 0; z < m_gridZ; ++z) {
-      const float zPos = static_cast<float>(z) * depthStep;
-      const float zCentered = (zPos - 0.5f) * 2.0f;
-
-      const float usageHist =
-          (z < static_cast<int>(m_history.size())) ? m_history[z] : 0.0f;
-      const float burstHist =
-          (z < static_cast<int>(m_burstHistory.size())) ? m_burstHistory[z] : 0.0f;
-
-      for (int x = 0; x < m_gridX; ++x) {
-        const float xPos = static_cast<float>(x) * widthStep;
-        const float xCentered = (xPos - 0.5f) * 2.0f;
-
-        const float spectrumH = InterpolateSpectrum(xPos);
-
-        const float macroWave =
-            std::sin(xCentered * 2.7f + zCentered * 1.9f + m_macroPhase) * 0.20f +
-            std::cos(zCentered * 2.1f - m_macroPhase * 0.8f) * 0.16f;
-
-        const float mesoWave =
-            std::sin(xCentered * 9.0f + m_mesoPhase + spectrumH * 5.5f) *
-            (0.06f + 0.18f * spectrumH);
-
-        const float fold = std::abs(std::sin(xCentered * 4.2f + zCentered * 3.0f +
-                                             m_time * 0.85f));
-
-        const float silhouette = std::pow(std::clamp(usageHist, 0.0f, 1.0f), 1.25f) *
-                                 1.55f;
-
-        float yPos = silhouette;
-        yPos += macroWave * (0.45f + usageHist * 0.65f);
-        yPos += mesoWave;
-        yPos += fold * (0.04f + burstHist * 0.22f);
-
-        const float depthMask = std::clamp(1.0f - zPos * 0.82f, 0.12f, 1.0f);
-        const float dreamBreath =
-            0.92f + 0.18f * std::sin(m_time * 0.35f + zPos * 5.2f + xPos * 1.8f);
-        yPos *= depthMask * dreamBreath;
-
-        heights[static_cast<size_t>(z * m_gridX + x)] = yPos;
+  // Static (x, z) grid for the GPU path, rebuilt only when its size changes.
+  void CreateDisplacedGrid(int size) {
+    DestroyDisplacedGrid();
+
+    std::vector<float> grid(static_cast<size_t>(size) * size * 2);
+    const float step = 1.0f / static_cast<float>(size - 1);
+    for (int z = 0; z < size; ++z) {
+      for (int x = 0; x < size; ++x) {
+        const size_t base = static_cast<size_t>(z * size + x) * 2;
+        grid[base + 0] = static_cast<float>(x) * step;
+        grid[base + 1] = static_cast<float>(z) * step;
+      }
+    }
+    std::vector<unsigned int> indices;
+    indices.reserve(static_cast<size_t>(size - 1) * (size - 1) * 6);
+    for (int z = 0; z < size - 1; ++z) {
+      for (int x = 0; x < size - 1; ++x) {
+        const unsigned int i0 = static_cast<unsigned int>(z * size + x);
+        const unsigned int i1 = i0 + 1;
+        const unsigned int i2 = i0 + static_cast<unsigned int>(size);
+        const unsigned int i3 = i2 + 1;
+        indices.insert(indices.end(), {i0, i2, i1, i1, i2, i3});
       }
     }
 
-    for (int z = 0; z < m_gridZ; ++z) {
-      for (int x = 0; x < m_gridX; ++x) {
-        const int xm = (x > 0) ? x - 1 : x;
-        const int xp = (x + 1 < m_gridX) ? x + 1 : x;
-        const int zm = (z > 0) ? z - 1 : z;
-        const int zp = (z + 1 < m_gridZ) ? z + 1 : z;
-
-        const float hL = heights[static_cast<size_t>(z * m_gridX + xm)];
-        const float hR = heights[static_cast<size_t>(z * m_gridX + xp)];
-        const float hD = heights[static_cast<size_t>(zm * m_gridX + x)];
-        const float hU = heights[static_cast<size_t>(zp * m_gridX + x)];
+    glGenVertexArrays(1, &m_gpuVao);
+    glGenBuffers(1, &m_gpuVbo);
+    glGenBuffers(1, &m_gpuIbo);
+    GLStateCache::Get().BindVertexArray(m_gpuVao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_gpuVbo);
+    glBufferData(GL_ARRAY_BUFFER, grid.size() * sizeof(float), grid.data(),
+                 GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
+                          reinterpret_cast<void *>(0));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gpuIbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+                 indices.data(), GL_STATIC_DRAW);
+    GLStateCache::Get().BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_gpuGridSize = size;
+    m_gpuIndexCount = static_cast<GLsizei>(indices.size());
+  }
 
-        const Vec3 n = Vec3Normalize(Vec3{-hR + hL, 2.0f, -hU + hD});
+  void DestroyDisplacedGrid() {
+    if (m_gpuVao) {
+      GLStateCache::Get().OnVertexArrayDeleted(m_gpuVao);
+      glDeleteVertexArrays(1, &m_gpuVao);
+      m_gpuVao = 0;
+    }
+    if (m_gpuVbo) {
+      glDeleteBuffers(1, &m_gpuVbo);
+      m_gpuVbo = 0;
+    }
+    if (m_gpuIbo) {
+      glDeleteBuffers(1, &m_gpuIbo);
+      m_gpuIbo = 0;
+    }
+    m_gpuGridSize = 0;
+    m_gpuIndexCount = 0;
+  }
 
-        const float xPos = static_cast<float>(x) / static_cast<float>(m_gridX - 1);
-        const float zPos = static_cast<float>(z) / static_cast<float>(m_gridZ - 1);
-        const float yPos = heights[static_cast<size_t>(z * m_gridX + x)];
+  // Mirrors the history ring into the RG32F history texture in storage
+  // order; the shader adds the write head (uHistoryHead) itself. A tick
+  // therefore uploads the single texel it wrote, and the texture is only
+  // uploaded whole after it is (re)created or fell a full ring behind.
+  void UploadHistory() {
+    const int length = static_cast<int>(m_history.GetCapacity());
+    if (m_historyTexLength != length) {
+      if (!m_historyTex) {
+        glGenTextures(1, &m_historyTex);
+      }
+      GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, m_historyTex);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, length, 1, 0, GL_RG, GL_FLOAT,
+                   nullptr);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      // Repeat, so filtering across the wrap point blends the right rows.
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      m_historyTexLength = length;
+      m_pendingHistoryTexels = length;
+    }
+    if (m_pendingHistoryTexels == 0) {
+      return;
+    }
 
-        const size_t base = static_cast<size_t>((z * m_gridX + x) * 8);
-        vertices[base + 0] = xPos;
-        vertices[base + 1] = yPos;
-        vertices[base + 2] = zPos;
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, m_historyTex);
+    if (m_pendingHistoryTexels >= length) {
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, length, 1, GL_RG, GL_FLOAT,
+                      m_history.Data());
+    } else {
+      // The newest entries, one texel each (normally just one).
+      for (int age = 0; age < m_pendingHistoryTexels; ++age) {
+        const int slot =
+            (static_cast<int>(m_history.GetHead()) + age) % length;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, slot, 0, 1, 1, GL_RG, GL_FLOAT,
+                        m_history.Data() + slot);
+      }
+    }
+    m_pendingHistoryTexels = 0;
+  }
 
-        vertices[base + 3] = n.x;
-        vertices[base + 4] = n.y;
-        vertices[base + 5] = n.z;
+  // Draws the static grid through the GPU_DISPLACEMENT shader, which must be
+  // current with its uniform handles resolved.
+  void DrawDisplaced(float macroPhase, float mesoPhase) {
+    m_gpuActive = true;
+    const int gridSize = std::clamp(m_config.cpuGpuGridSize, 2, 512);
+    if (gridSize != m_gpuGridSize) {
+      CreateDisplacedGrid(gridSize);
+    }
+    UploadHistory();
 
-        vertices[base + 6] = xPos;
-        vertices[base + 7] = zPos;
-      }
+    m_uniforms.history.Set(0);
+    m_uniforms.historyLength.Set(static_cast<float>(m_historyTexLength));
+    m_uniforms.historyHead.Set(static_cast<float>(m_history.GetHead()));
+    if (m_uniforms.spectrum >= 0) {
+      glUniform1fv(m_uniforms.spectrum, kSpectrumBands, m_spectrum.data());
     }
+    m_uniforms.macroPhase.Set(macroPhase);
+    m_uniforms.mesoPhase.Set(mesoPhase);
+    m_uniforms.normalStep.Set(1.0f / static_cast<float>(m_gridZ - 1));
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float),
-                    vertices.data());
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, m_historyTex);
+    GLStateCache::Get().BindVertexArray(m_gpuVao);
+    glDrawElements(GL_TRIANGLES, m_gpuIndexCount, GL_UNSIGNED_INT, nullptr);
   }
 
+  // CPU height field, see CPUVisualizer.cpp.
+  void ResizeMeshBuffers();
+  void UpdateMesh();
+  void WriteBlendedMesh(float alpha);
+
+  static constexpr size_t kVertexSize = (3 + 3 + 2) * sizeof(float);
+
   const Config &m_config;
 
   int m_gridX = 40;
   int m_gridZ = 40;
 
-  std::deque<float> m_history;
-  std::deque<float> m_burstHistory;
-  std::vector<float> m_spectrum;
+  // One history row per grid row, newest first; laid out as the RG32F
+  // texels of the history texture.
+  struct HistorySample {
+    float usage = 0.0f;
+    float burst = 0.0f;
+  };
+  // Uploaded as-is as RG32F texels.
+  static_assert(sizeof(HistorySample) == 2 * sizeof(float),
+                "HistorySample must match the RG32F history texel");
+  static constexpr int kSpectrumBands = 10; // uSpectrum in cpu_surreal.vert
+
+  RingBuffer<HistorySample> m_history;
+  std::array<float, kSpectrumBands> m_spectrum{};
 
   float m_time = 0.0f;
   float m_updateTimer = 0.0f;
@@ -300,8 +407,74 @@ private:
   float m_macroPhase = 0.0f;
   float m_mesoPhase = 0.0f;
 
+  // State at the previous simulation step, for interpolated drawing.
+  float m_prevTime = 0.0f;
+  float m_prevMacroPhase = 0.0f;
+  float m_prevMesoPhase = 0.0f;
+
+  // CPU path scratch, sized by ResizeMeshBuffers and reused every step.
+  // Per-column terms only depend on the grid (plus the spectrum for the
+  // meso wave), so the per-vertex work is a few multiply-adds; the trig
+  // runs once per row and column instead of three times per vertex.
+  struct MeshColumns {
+    std::vector<float> pos;      // x in [0, 1]
+    std::vector<float> centered; // x in [-1, 1]
+    std::vector<float> sinMacro, cosMacro;
+    std::vector<float> sinFold, cosFold;
+    std::vector<float> sinBreath, cosBreath;
+    std::vector<float> mesoAngle, mesoAmp, meso, scratch;
+  };
+  struct MeshRows {
+    // Four blocks of m_rowCount angles: macro, fold, breath, macro cosine.
+    std::vector<float> angle, sin, cos;
+  };
+  size_t m_columnCount = 0; // m_gridX rounded up to whole SIMD blocks
+  size_t m_rowCount = 0;    // m_gridZ rounded up to whole SIMD blocks
+  size_t m_rowStride = 0;   // Heights row: guard, m_gridX heights, guard, pad
+  // Heights (m_rowStride per row) and normals (m_columnCount per row) of
+  // one simulation step. Draw blends the previous step into the latest.
+  struct MeshStep {
+    std::vector<float> heights;
+    std::vector<float> normalX, normalY, normalZ;
+  };
+  MeshStep m_mesh;
+  MeshStep m_prevMesh;
+  MeshColumns m_columns;
+  MeshRows m_rows;
+
   GLuint m_vao = 0;
-  GLuint m_vbo = 0;
+  StreamingBuffer m_vertexStream;
   GLuint m_ibo = 0;
   std::vector<unsigned int> m_indices;
+
+  // GPU displacement path
+  bool m_gpuActive = false; // Last Draw used the GPU_DISPLACEMENT shader
+  GLuint m_gpuVao = 0;
+  GLuint m_gpuVbo = 0;
+  GLuint m_gpuIbo = 0;
+  int m_gpuGridSize = 0;
+  GLsizei m_gpuIndexCount = 0;
+  GLuint m_historyTex = 0;
+  int m_historyTexLength = 0;
+  int m_pendingHistoryTexels = 0; // Ticks not yet mirrored, capped at length
+
+  // Uniform handles for the program last passed to Draw.
+  struct DrawUniforms {
+    GLuint program = 0;
+    Uniform<Mat4> model;
+    Uniform<float> time;
+    Uniform<float> energy;
+    Uniform<float> palettePhase;
+    Uniform<Vec3> color;
+    Uniform<float> burst;
+    // GPU_DISPLACEMENT variant only
+    Uniform<int> history;
+    Uniform<float> historyLength;
+    Uniform<float> historyHead;
+    GLint spectrum = -1;
+    Uniform<float> macroPhase;
+    Uniform<float> mesoPhase;
+    Uniform<float> normalStep;
+  };
+  DrawUniforms m_uniforms;
 };
@@ -14,9 +14,13 @@ public:
   void Init() override {}
 
   void Update(float dt, const SystemMonitor &monitor) override {
+    m_prevUsage = m_currentUsage;
+    m_prevRotation = m_rotation;
+
     m_currentUsage = static_cast<float>(monitor.GetDiskUsage());
-    float u = GetEffectiveUsage();
-    m_rotation += 1.0f + (u * 50.0f);
+    float u = GetEffectiveUsage(m_currentUsage);
+    // Degrees per second; matches the old per-frame step at 60 fps.
+    m_rotation += (1.0f + (u * 50.0f)) * 60.0f * dt;
   }
 
   void Draw(Shader *shader, const Mat4 &sceneTransform) override {
@@ -27,18 +31,25 @@ public:
     if (!shader || !shader->IsValid())
       return;
 
-    float u = GetEffectiveUsage();
+    float u =
+        GetEffectiveUsage(Lerp(m_prevUsage, m_currentUsage, m_interpolation));
+    float rotation = Lerp(m_prevRotation, m_rotation, m_interpolation);
     float ringScale = (2.2f + (u * 0.5f)) / 2.2f;
 
     // Rotate 90 degrees on X axis, then by current rotation on Z
     Mat4 rotate = Mat4Multiply(Mat4RotateX(1.5707964f),
-                               Mat4RotateZ(m_rotation * 0.0174533f));
+                               Mat4RotateZ(rotation * 0.0174533f));
     Mat4 scale = Mat4Scale(ringScale, ringScale, ringScale);
     Mat4 model = Mat4Multiply(sceneTransform, Mat4Multiply(rotate, scale));
 
     shader->Use();
-    shader->SetMat4("uModel", model.m.data());
-    shader->SetVec3("uColor", 0.5f + u * 0.5f, 0.5f + u * 0.5f, 0.0f);
+    if (m_uniforms.program != shader->GetId()) {
+      m_uniforms.program = shader->GetId();
+      m_uniforms.model = Uniform<Mat4>(*shader, "uModel");
+      m_uniforms.color = Uniform<Vec3>(*shader, "uColor");
+    }
+    m_uniforms.model.Set(model);
+    m_uniforms.color.Set(Vec3{0.5f + u * 0.5f, 0.5f + u * 0.5f, 0.0f});
     DrawMesh(GetMesh());
   }
 
@@ -47,8 +58,8 @@ public:
   bool IsEnabled() const override { return m_config.diskMetric.enabled; }
 
 private:
-  float GetEffectiveUsage() const {
-    float effective = m_currentUsage - m_config.diskMetric.threshold;
+  float GetEffectiveUsage(float usage) const {
+    float effective = usage - m_config.diskMetric.threshold;
     if (effective < 0.0f)
       effective = 0.0f;
     float u = (effective / (100.0f - m_config.diskMetric.threshold)) *
@@ -73,4 +84,14 @@ private:
   Mesh &m_ringMesh;
   float m_currentUsage = 0.0f;
   float m_rotation = 0.0f;
+  float m_prevUsage = 0.0f;
+  float m_prevRotation = 0.0f;
+
+  // Uniform handles for the program last passed to Draw.
+  struct DrawUniforms {
+    GLuint program = 0;
+    Uniform<Mat4> model;
+    Uniform<Vec3> color;
+  };
+  DrawUniforms m_uniforms;
 };
@@ -1,9 +1,94 @@
 #include "FractalSurfaceVisualizer.h"
 
+#include "../engine/SimdMath.h"
+#include "../engine/ThreadPool.h"
 #include "../glad/glad.h"
+#include "../graphics/GLStateCache.h"
 #include <algorithm>
 #include <cmath>
 
+namespace {
+// Rows per ParallelFor chunk; EvalHeight is heavy (three fBm calls per
+// vertex), so small chunks still amortize the scheduling.
+constexpr size_t kRowsPerChunk = 2;
+
+// Lane-width wrappers for the row kernel below, so the fBm is written once
+// for AVX2 and SSE2. Each maps to the single instruction its name says; the
+// kernel must keep the operation order of the scalar EvalHeight/FBm/
+// SmoothNoise/Noise2D chain, which is what makes the two bit-identical.
+#if defined(SCREENSAVER_SIMD_AVX2)
+using FloatV = __m256;
+constexpr size_t kLanes = 8;
+inline FloatV Set1(float v) { return _mm256_set1_ps(v); }
+inline FloatV Load(const float *p) { return _mm256_loadu_ps(p); }
+inline void Store(float *p, FloatV v) { _mm256_storeu_ps(p, v); }
+inline FloatV Add(FloatV a, FloatV b) { return _mm256_add_ps(a, b); }
+inline FloatV Sub(FloatV a, FloatV b) { return _mm256_sub_ps(a, b); }
+inline FloatV Mul(FloatV a, FloatV b) { return _mm256_mul_ps(a, b); }
+inline FloatV Abs(FloatV v) {
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+}
+#elif defined(SCREENSAVER_SIMD_SSE2)
+using FloatV = __m128;
+constexpr size_t kLanes = 4;
+inline FloatV Set1(float v) { return _mm_set1_ps(v); }
+inline FloatV Load(const float *p) { return _mm_loadu_ps(p); }
+inline void Store(float *p, FloatV v) { _mm_storeu_ps(p, v); }
+inline FloatV Add(FloatV a, FloatV b) { return _mm_add_ps(a, b); }
+inline FloatV Sub(FloatV a, FloatV b) { return _mm_sub_ps(a, b); }
+inline FloatV Mul(FloatV a, FloatV b) { return _mm_mul_ps(a, b); }
+inline FloatV Abs(FloatV v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+#endif
+
+#if defined(SCREENSAVER_SIMD_AVX2) || defined(SCREENSAVER_SIMD_SSE2)
+// Noise2D
+inline FloatV NoiseV(FloatV x, FloatV y, FloatV seed) {
+  const FloatV v =
+      Mul(Simd::Sin(Add(Add(Mul(x, Set1(127.1f)), Mul(y, Set1(311.7f))), seed)),
+          Set1(43758.5453123f));
+  return Sub(v, Simd::Floor(v));
+}
+
+// SmoothNoise
+inline FloatV SmoothNoiseV(FloatV x, FloatV y, FloatV seed) {
+  const FloatV ix = Simd::Floor(x);
+  const FloatV iy = Simd::Floor(y);
+  const FloatV fx = Sub(x, ix);
+  const FloatV fy = Sub(y, iy);
+  const FloatV one = Set1(1.0f);
+
+  const FloatV a = NoiseV(ix, iy, seed);
+  const FloatV b = NoiseV(Add(ix, one), iy, seed);
+  const FloatV c = NoiseV(ix, Add(iy, one), seed);
+  const FloatV d = NoiseV(Add(ix, one), Add(iy, one), seed);
+
+  const FloatV three = Set1(3.0f);
+  const FloatV two = Set1(2.0f);
+  const FloatV ux = Mul(Mul(fx, fx), Sub(three, Mul(two, fx)));
+  const FloatV uy = Mul(Mul(fy, fy), Sub(three, Mul(two, fy)));
+
+  const FloatV ab = Add(a, Mul(Sub(b, a), ux));
+  const FloatV cd = Add(c, Mul(Sub(d, c), ux));
+  return Add(ab, Mul(Sub(cd, ab), uy));
+}
+
+// FBm
+inline FloatV FBmV(FloatV x, FloatV y, FloatV seed, int octaves,
+                   float lacunarity, float gain) {
+  FloatV sum = Set1(0.0f);
+  float amp = 0.5f;
+  const FloatV lac = Set1(lacunarity);
+  for (int i = 0; i < octaves; ++i) {
+    sum = Add(sum, Mul(SmoothNoiseV(x, y, seed), Set1(amp)));
+    x = Mul(x, lac);
+    y = Mul(y, lac);
+    amp *= gain;
+  }
+  return sum;
+}
+#endif
+} // namespace
+
 FractalSurfaceVisualizer::FractalSurfaceVisualizer(const Config &config)
     : m_config(config) {}
 
@@ -23,16 +108,14 @@ void FractalSurfaceVisualizer::Init() {
 
   if (m_vao == 0)
     glGenVertexArrays(1, &m_vao);
-  if (m_vbo == 0)
-    glGenBuffers(1, &m_vbo);
   if (m_ibo == 0)
     glGenBuffers(1, &m_ibo);
 
-  glBindVertexArray(m_vao);
+  m_vertexStream.Create(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex));
+
+  GLStateCache::Get().BindVertexArray(m_vao);
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-  glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex),
-               m_vertices.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, m_vertexStream.GetBuffer());
 
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER,
@@ -47,10 +130,11 @@ void FractalSurfaceVisualizer::Init() {
   glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
                         reinterpret_cast<void *>(3 * sizeof(float)));
 
-  glBindVertexArray(0);
+  GLStateCache::Get().BindVertexArray(0);
 }
 
 void FractalSurfaceVisualizer::Update(float dt, const SystemMonitor &monitor) {
+  m_prevTime = m_time;
   m_time += dt;
   m_signalProcessor.Update(dt, monitor, m_config);
   UpdateMesh();
@@ -69,21 +153,32 @@ void FractalSurfaceVisualizer::Draw(Shader *shader, const Mat4 &sceneTransform)
   Mat4 model = Mat4Multiply(sceneTransform, Mat4Multiply(translate, Mat4Multiply(rotate, scale)));
 
   shader->Use();
-  shader->SetMat4("uModel", model.m.data());
-  shader->SetFloat("uTime", m_time);
-  shader->SetFloat("uEnergy", params.energy);
-  shader->SetFloat("uPalettePhase", params.palettePhase);
+  if (m_uniforms.program != shader->GetId()) {
+    m_uniforms.program = shader->GetId();
+    m_uniforms.model = Uniform<Mat4>(*shader, "uModel");
+    m_uniforms.time = Uniform<float>(*shader, "uTime");
+    m_uniforms.energy = Uniform<float>(*shader, "uEnergy");
+    m_uniforms.palettePhase = Uniform<float>(*shader, "uPalettePhase");
+    m_uniforms.color = Uniform<Vec3>(*shader, "uColor");
+  }
+  m_uniforms.model.Set(model);
+  m_uniforms.time.Set(Lerp(m_prevTime, m_time, m_interpolation));
+  m_uniforms.energy.Set(params.energy);
+  m_uniforms.palettePhase.Set(params.palettePhase);
 
   float hue = std::fmod(params.palettePhase * 0.09f, 1.0f);
   float r = 0.25f + 0.75f * std::sin((hue + 0.0f) * 6.28318f) * 0.5f + 0.25f;
   float g = 0.25f + 0.75f * std::sin((hue + 0.33f) * 6.28318f) * 0.5f + 0.25f;
   float b = 0.25f + 0.75f * std::sin((hue + 0.66f) * 6.28318f) * 0.5f + 0.25f;
-  shader->SetVec3("uColor", r, g, b);
-
-  glBindVertexArray(m_vao);
-  glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()),
-                 GL_UNSIGNED_INT, nullptr);
-  glBindVertexArray(0);
+  m_uniforms.color.Set(Vec3{r, g, b});
+
+  WriteBlendedMesh(m_interpolation);
+  const GLint baseVertex =
+      static_cast<GLint>(m_vertexStream.GetRegionOffset() / sizeof(Vertex));
+  GLStateCache::Get().BindVertexArray(m_vao);
+  glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()),
+                           GL_UNSIGNED_INT, nullptr, baseVertex);
+  m_vertexStream.Fence();
 }
 
 void FractalSurfaceVisualizer::Cleanup() {
@@ -91,11 +186,9 @@ void FractalSurfaceVisualizer::Cleanup() {
     glDeleteBuffers(1, &m_ibo);
     m_ibo = 0;
   }
-  if (m_vbo) {
-    glDeleteBuffers(1, &m_vbo);
-    m_vbo = 0;
-  }
+  m_vertexStream.Destroy();
   if (m_vao) {
+    GLStateCache::Get().OnVertexArrayDeleted(m_vao);
     glDeleteVertexArrays(1, &m_vao);
     m_vao = 0;
   }
@@ -110,6 +203,14 @@ void FractalSurfaceVisualizer::BuildGrid() {
   m_indices.clear();
 
   m_vertices.resize(static_cast<size_t>(m_resX * m_resZ));
+  // Column positions padded to whole SIMD blocks, plus a padded height row
+  // per grid row for EvalHeightRow.
+  m_columnX.assign(Simd::RoundUpToLanes(static_cast<size_t>(m_resX)), 0.0f);
+  for (size_t x = 0; x < m_columnX.size(); ++x) {
+    const float u = static_cast<float>(x) / static_cast<float>(m_resX - 1);
+    m_columnX[x] = (u - 0.5f) * m_gridScale;
+  }
+  m_heights.assign(m_columnX.size() * static_cast<size_t>(m_resZ), 0.0f);
 
   for (int z = 0; z < m_resZ; ++z) {
     for (int x = 0; x < m_resX; ++x) {
@@ -126,6 +227,8 @@ void FractalSurfaceVisualizer::BuildGrid() {
     }
   }
 
+  m_prevVertices = m_vertices;
+
   for (int z = 0; z < m_resZ - 1; ++z) {
     for (int x = 0; x < m_resX - 1; ++x) {
       unsigned int i0 = static_cast<unsigned int>(z * m_resX + x);
@@ -145,40 +248,71 @@ void FractalSurfaceVisualizer::BuildGrid() {
 }
 
 void FractalSurfaceVisualizer::UpdateMesh() {
-  const FractalParams &params = m_signalProcessor.GetParams();
-
-  for (int z = 0; z < m_resZ; ++z) {
-    for (int x = 0; x < m_resX; ++x) {
-      Vertex &vert = m_vertices[static_cast<size_t>(z * m_resX + x)];
-      vert.py = EvalHeight(vert.px, vert.pz);
+  // The latest step becomes the previous one; x and z never change, so the
+  // older buffer only needs its heights and normals rewritten.
+  m_vertices.swap(m_prevVertices);
+
+  // Rows are independent, and the normal pass only starts once every
+  // height is in (ParallelFor returns after all of its chunks).
+  ThreadPool &pool = ThreadPool::Get();
+  const size_t rows = static_cast<size_t>(m_resZ);
+  pool.ParallelFor(rows, kRowsPerChunk, [this](size_t first, size_t last) {
+    for (size_t z = first; z < last; ++z) {
+      float *heights = m_heights.data() + z * m_columnX.size();
+      Vertex *row = m_vertices.data() + z * static_cast<size_t>(m_resX);
+      EvalHeightRow(m_columnX.data(), row->pz, heights, m_columnX.size());
+      for (int x = 0; x < m_resX; ++x) {
+        row[x].py = heights[x];
+      }
     }
-  }
-
-  for (int z = 0; z < m_resZ; ++z) {
-    for (int x = 0; x < m_resX; ++x) {
-      const int xm = (x > 0) ? x - 1 : x;
-      const int xp = (x + 1 < m_resX) ? x + 1 : x;
-      const int zm = (z > 0) ? z - 1 : z;
-      const int zp = (z + 1 < m_resZ) ? z + 1 : z;
-
-      const float hL = m_vertices[static_cast<size_t>(z * m_resX + xm)].py;
-      const float hR = m_vertices[static_cast<size_t>(z * m_resX + xp)].py;
-      const float hD = m_vertices[static_cast<size_t>(zm * m_resX + x)].py;
-      const float hU = m_vertices[static_cast<size_t>(zp * m_resX + x)].py;
-
-      Vec3 n = Vec3Normalize(Vec3{-hR + hL, 2.0f, -hU + hD});
-      Vertex &vert = m_vertices[static_cast<size_t>(z * m_resX + x)];
-      vert.nx = n.x;
-      vert.ny = n.y;
-      vert.nz = n.z;
+  });
+
+  pool.ParallelFor(rows, kRowsPerChunk, [this](size_t first, size_t last) {
+    for (int z = static_cast<int>(first); z < static_cast<int>(last); ++z) {
+      for (int x = 0; x < m_resX; ++x) {
+        const int xm = (x > 0) ? x - 1 : x;
+        const int xp = (x + 1 < m_resX) ? x + 1 : x;
+        const int zm = (z > 0) ? z - 1 : z;
+        const int zp = (z + 1 < m_resZ) ? z + 1 : z;
+
+        const float hL = m_vertices[static_cast<size_t>(z * m_resX + xm)].py;
+        const float hR = m_vertices[static_cast<size_t>(z * m_resX + xp)].py;
+        const float hD = m_vertices[static_cast<size_t>(zm * m_resX + x)].py;
+        const float hU = m_vertices[static_cast<size_t>(zp * m_resX + x)].py;
+
+        Vec3 n = Vec3Normalize(Vec3{-hR + hL, 2.0f, -hU + hD});
+        Vertex &vert = m_vertices[static_cast<size_t>(z * m_resX + x)];
+        vert.nx = n.x;
+        vert.ny = n.y;
+        vert.nz = n.z;
+      }
     }
-  }
-
-  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-  glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(Vertex),
-                  m_vertices.data());
+  });
+}
 
-  (void)params;
+// Writes the mesh between the last two simulation steps into the next
+// stream region, so the surface moves every frame rather than once per
+// step. The normal pass reads neighbouring heights, which is why the steps
+// are built in m_vertices / m_prevVertices and only blended here, written
+// once and in order into the mapped region.
+void FractalSurfaceVisualizer::WriteBlendedMesh(float alpha) {
+  Vertex *mapped = static_cast<Vertex *>(m_vertexStream.BeginWrite());
+  if (!mapped) {
+    return;
+  }
+  for (size_t i = 0; i < m_vertices.size(); ++i) {
+    const Vertex &prev = m_prevVertices[i];
+    const Vertex &cur = m_vertices[i];
+    // Normals are renormalized in fractal_surface.vert.
+    mapped[i] = Vertex{cur.px,
+                       Lerp(prev.py, cur.py, alpha),
+                       cur.pz,
+                       Lerp(prev.nx, cur.nx, alpha),
+                       Lerp(prev.ny, cur.ny, alpha),
+                       Lerp(prev.nz, cur.nz, alpha)};
+  }
+  m_vertexStream.EndWrite();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 float FractalSurfaceVisualizer::EvalHeight(float x, float z) const {
@@ -203,15 +337,68 @@ float FractalSurfaceVisualizer::EvalHeight(float x, float z) const {
   return mixed * p.amplitude;
 }
 
+// EvalHeight over a row, a SIMD block at a time; the tail (and builds with
+// SCREENSAVER_SIMD_SCALAR) go through the scalar reference.
+void FractalSurfaceVisualizer::EvalHeightRow(const float *xs, float z,
+                                             float *out, size_t count) const {
+  size_t i = 0;
+
+#if defined(SCREENSAVER_SIMD_AVX2) || defined(SCREENSAVER_SIMD_SSE2)
+  const FractalParams &p = m_signalProcessor.GetParams();
+  const float t = m_time * p.warpSpeed;
+  const FloatV seed = Set1(m_config.fractalSeed * 0.01f);
+
+  const FloatV fz = Set1(z * p.baseScale);
+  const FloatV warpXz = Sub(fz, Set1(t * 0.19f));
+  const FloatV warpZz = Add(fz, Set1(t * 0.11f));
+  const FloatV half = Set1(0.5f);
+  const FloatV warpAmount = Set1(p.warpAmount);
+  const FloatV four = Set1(4.0f);
+  const FloatV one = Set1(1.0f);
+  const FloatV two = Set1(2.0f);
+  const FloatV ridgeMix = Set1(p.ridgeMix);
+  const FloatV baseMix = Set1(1.0f - p.ridgeMix);
+  const FloatV amplitude = Set1(p.amplitude);
+
+  for (; i + kLanes <= count; i += kLanes) {
+    const FloatV fx = Mul(Load(xs + i), Set1(p.baseScale));
+
+    const FloatV warpX = FBmV(Add(fx, Set1(t * 0.13f)), warpXz, seed,
+                              p.octaves, p.lacunarity, p.gain);
+    const FloatV warpZ = FBmV(Sub(fx, Set1(t * 0.17f)), warpZz, seed,
+                              p.octaves, p.lacunarity, p.gain);
+
+    const FloatV qx = Add(fx, Mul(Mul(Sub(warpX, half), warpAmount), four));
+    const FloatV qz = Add(fz, Mul(Mul(Sub(warpZ, half), warpAmount), four));
+
+    const FloatV base =
+        Sub(FBmV(qx, qz, seed, p.octaves, p.lacunarity, p.gain), half);
+    const FloatV ridge = Sub(one, Abs(Mul(base, two)));
+    const FloatV mixed =
+        Add(Mul(base, baseMix), Mul(Mul(ridge, ridgeMix), half));
+    Store(out + i, Mul(mixed, amplitude));
+  }
+#endif
+
+  for (; i < count; ++i) {
+    out[i] = EvalHeight(xs[i], z);
+  }
+}
+
+// Noise2D, SmoothNoise and FBm are the scalar reference of NoiseV,
+// SmoothNoiseV and FBmV and must stay bit-identical to them: any change
+// here has to be mirrored there. The hash uses Simd::Sin rather than
+// std::sin for that reason.
 float FractalSurfaceVisualizer::Noise2D(float x, float y) const {
-  const float v = std::sin(x * 127.1f + y * 311.7f + m_config.fractalSeed * 0.01f) *
-                  43758.5453123f;
-  return v - std::floor(v);
+  const float v =
+      Simd::Sin(x * 127.1f + y * 311.7f + m_config.fractalSeed * 0.01f) *
+      43758.5453123f;
+  return v - Simd::Floor(v);
 }
 
 float FractalSurfaceVisualizer::SmoothNoise(float x, float y) const {
-  const float ix = std::floor(x);
-  const float iy = std::floor(y);
+  const float ix = Simd::Floor(x);
+  const float iy = Simd::Floor(y);
   const float fx = x - ix;
   const float fy = y - iy;
 
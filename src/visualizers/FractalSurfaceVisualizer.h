@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../fractal/FractalSignalProcessor.h"
+#include "../graphics/StreamingBuffer.h"
 #include "IVisualizer.h"
 #include <vector>
 
@@ -15,6 +16,8 @@ public:
   bool IsEnabled() const override;
 
 private:
+  friend class FractalSurfaceVisualizerTest; // tests/FractalSimdTests.cpp
+
   struct Vertex {
     float px;
     float py;
@@ -26,7 +29,11 @@ private:
 
   void BuildGrid();
   void UpdateMesh();
+  void WriteBlendedMesh(float alpha);
   float EvalHeight(float x, float z) const;
+  // EvalHeight of (xs[i], z) for i < count, SIMD-wide; bit-identical to the
+  // scalar EvalHeight.
+  void EvalHeightRow(const float *xs, float z, float *out, size_t count) const;
   float Noise2D(float x, float y) const;
   float SmoothNoise(float x, float y) const;
   float FBm(float x, float y, int octaves, float lacunarity, float gain) const;
@@ -35,14 +42,29 @@ private:
   FractalSignalProcessor m_signalProcessor;
 
   GLuint m_vao = 0;
-  GLuint m_vbo = 0;
+  StreamingBuffer m_vertexStream;
   GLuint m_ibo = 0;
 
-  std::vector<Vertex> m_vertices;
+  std::vector<Vertex> m_vertices;     // Mesh at the latest simulation step
+  std::vector<Vertex> m_prevVertices; // Mesh at the step before it
+  std::vector<float> m_columnX; // Vertex x per column, padded (BuildGrid)
+  std::vector<float> m_heights; // One padded row of heights per grid row
   std::vector<unsigned int> m_indices;
 
   int m_resX = 96;
   int m_resZ = 96;
   float m_time = 0.0f;
+  float m_prevTime = 0.0f;
   float m_gridScale = 6.0f;
+
+  // Uniform handles for the program last passed to Draw.
+  struct DrawUniforms {
+    GLuint program = 0;
+    Uniform<Mat4> model;
+    Uniform<float> time;
+    Uniform<float> energy;
+    Uniform<float> palettePhase;
+    Uniform<Vec3> color;
+  };
+  DrawUniforms m_uniforms;
 };
@@ -26,4 +26,12 @@ public:
 
   // Check if this visualizer is enabled
   virtual bool IsEnabled() const = 0;
+
+  // Update runs at a fixed rate; before each Draw the engine passes how far
+  // (0-1) the render time is into the next step. Draw blends the previous
+  // and current simulation state with it. 1 draws the latest state.
+  void SetInterpolation(float alpha) { m_interpolation = alpha; }
+
+protected:
+  float m_interpolation = 1.0f;
 };
@@ -14,18 +14,23 @@ public:
   void Init() override {}
 
   void Update(float dt, const SystemMonitor &monitor) override {
+    m_prevUsage = m_currentUsage;
+    m_prevPulse = m_pulse;
+
     float targetUsage = static_cast<float>(monitor.GetRamUsage());
     m_currentUsage += (targetUsage - m_currentUsage) * dt * 2.0f; // Soft Lerp
-    m_pulse += dt * (1.0f + GetEffectiveUsage() * 0.5f);
+    m_pulse += dt * (1.0f + GetEffectiveUsage(m_currentUsage) * 0.5f);
   }
 
   void Draw(Shader *shader, const Mat4 &sceneTransform) override {
     if (!IsEnabled() || !shader)
       return;
 
-    float u = GetEffectiveUsage();
+    float u = GetEffectiveUsage(
+        Lerp(m_prevUsage, m_currentUsage, m_interpolation));
+    float pulse = Lerp(m_prevPulse, m_pulse, m_interpolation);
     // Pulse scale: Base + Usage + SineWave
-    float scale = 1.0f + (u * 1.5f) + (std::sin(m_pulse) * 0.1f);
+    float scale = 1.0f + (u * 1.5f) + (std::sin(pulse) * 0.1f);
 
     Mat4 transform = Mat4Translate(0.0f, 0.0f, 0.0f);
     transform = Mat4Multiply(sceneTransform, transform);
@@ -33,14 +38,19 @@ public:
     Mat4 model = Mat4Multiply(transform, Mat4Scale(scale, scale, scale));
 
     // Rotate slowly
-    model = Mat4Multiply(model, Mat4RotateY(m_pulse * 0.5f));
-    model = Mat4Multiply(model, Mat4RotateX(m_pulse * 0.3f));
+    model = Mat4Multiply(model, Mat4RotateY(pulse * 0.5f));
+    model = Mat4Multiply(model, Mat4RotateX(pulse * 0.3f));
 
     shader->Use();
-    shader->SetMat4("uModel", model.m.data());
+    if (m_uniforms.program != shader->GetId()) {
+      m_uniforms.program = shader->GetId();
+      m_uniforms.model = Uniform<Mat4>(*shader, "uModel");
+      m_uniforms.color = Uniform<Vec3>(*shader, "uColor");
+    }
+    m_uniforms.model.Set(model);
 
     // Color: Blue/Cyan based on usage
-    shader->SetVec3("uColor", 0.1f, 0.5f + (u * 0.5f), 1.0f);
+    m_uniforms.color.Set(Vec3{0.1f, 0.5f + (u * 0.5f), 1.0f});
 
     DrawMesh(GetMesh());
   }
@@ -50,9 +60,9 @@ public:
   bool IsEnabled() const override { return m_config.ramMetric.enabled; }
 
 private:
-  float GetEffectiveUsage() const {
+  float GetEffectiveUsage(float usage) const {
     // Normalize 0-100 to 0-1 based on Threshold/Strength
-    float effective = m_currentUsage - m_config.ramMetric.threshold;
+    float effective = usage - m_config.ramMetric.threshold;
     if (effective < 0)
       effective = 0;
     float range = 100.0f - m_config.ramMetric.threshold;
@@ -80,4 +90,14 @@ private:
   Mesh &m_ringMesh;
   float m_currentUsage = 0.0f;
   float m_pulse = 0.0f;
+  float m_prevUsage = 0.0f;
+  float m_prevPulse = 0.0f;
+
+  // Uniform handles for the program last passed to Draw.
+  struct DrawUniforms {
+    GLuint program = 0;
+    Uniform<Mat4> model;
+    Uniform<Vec3> color;
+  };
+  DrawUniforms m_uniforms;
 };
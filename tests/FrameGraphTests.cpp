@@ -0,0 +1,114 @@
+// Checks FrameGraph culling and ordering without a GL context. Only
+// imported targets are used, so Execute never touches the render target
+// pool or issues GL calls.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "graphics/FrameGraph.h"
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++g_failures;
+  }
+}
+
+using Names = std::vector<std::string>;
+
+FrameGraph::ExecuteFn Record(Names &ran, const char *name) {
+  return [&ran, name](const FrameGraph &) { ran.push_back(name); };
+}
+
+// Draw, trails, bloom and composite all read and write the same layer
+// target, as the engine declares them. They must run in declaration order.
+void TestReadModifyWriteChain() {
+  RenderTarget layerTarget, history, trail;
+  FrameGraph graph;
+  Names ran;
+  const FrameGraphResource layer = graph.Import("Layer", &layerTarget);
+  const FrameGraphResource hist = graph.Import("TrailHistory", &history);
+  const FrameGraphResource next = graph.Import("Trail", &trail);
+  const FrameGraphResource backbuffer = graph.ImportBackbuffer(64, 64);
+
+  graph.AddPass(
+      "Draw", [&](FrameGraph::Builder &b) { b.Write(layer); },
+      Record(ran, "Draw"));
+  graph.AddPass(
+      "Trails",
+      [&](FrameGraph::Builder &b) {
+        b.Read(layer);
+        b.Read(hist);
+        b.Write(next);
+        b.Write(layer);
+      },
+      Record(ran, "Trails"));
+  graph.AddPass(
+      "Bloom",
+      [&](FrameGraph::Builder &b) {
+        b.Read(layer);
+        b.Write(layer);
+      },
+      Record(ran, "Bloom"));
+  graph.AddPass(
+      "Composite",
+      [&](FrameGraph::Builder &b) {
+        b.Read(layer);
+        b.Write(backbuffer);
+      },
+      Record(ran, "Composite"));
+
+  graph.Compile();
+  graph.Execute();
+  Check(ran == Names{"Draw", "Trails", "Bloom", "Composite"},
+        "read-modify-write chain runs in declaration order");
+  Check(graph.GetCulledPassCount() == 0, "no pass in the chain is culled");
+}
+
+// A write nobody reads afterwards is culled, even if an earlier pass read
+// the resource, and so is a pass whose output is never read.
+void TestCullsUnreadVersions() {
+  RenderTarget layerTarget, scratchTarget;
+  FrameGraph graph;
+  Names ran;
+  const FrameGraphResource layer = graph.Import("Layer", &layerTarget);
+  const FrameGraphResource scratch = graph.Import("Scratch", &scratchTarget);
+  const FrameGraphResource backbuffer = graph.ImportBackbuffer(64, 64);
+
+  graph.AddPass(
+      "Draw", [&](FrameGraph::Builder &b) { b.Write(layer); },
+      Record(ran, "Draw"));
+  graph.AddPass(
+      "Unread", [&](FrameGraph::Builder &b) { b.Write(scratch); },
+      Record(ran, "Unread"));
+  graph.AddPass(
+      "Composite",
+      [&](FrameGraph::Builder &b) {
+        b.Read(layer);
+        b.Write(backbuffer);
+      },
+      Record(ran, "Composite"));
+  graph.AddPass(
+      "Late", [&](FrameGraph::Builder &b) { b.Write(layer); },
+      Record(ran, "Late"));
+
+  graph.Compile();
+  graph.Execute();
+  Check(ran == Names{"Draw", "Composite"}, "unread writes are culled");
+  Check(graph.GetCulledPassCount() == 2, "two passes culled");
+}
+
+} // namespace
+
+int main() {
+  TestReadModifyWriteChain();
+  TestCullsUnreadVersions();
+  if (g_failures == 0) {
+    std::printf("FrameGraph tests passed\n");
+  }
+  return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+// Checks the CPU particle kernels: the SIMD Integrate must be bit-identical
+// to its scalar loop (IntegrateScalar), including a live count that is not a
+// multiple of the lane width, and CompactDead must keep every survivor, in
+// order. Built with the same SIMD flags as the screensaver, so it covers
+// SSE2 by default and AVX2 with SCREENSAVER_ENABLE_AVX2.
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Particles.h"
+#include "engine/Simd.h"
+
+class ParticlesTest {
+public:
+  explicit ParticlesTest(Particles &particles) : particles_(particles) {}
+
+  // Fills `count` live particles (and the padding behind them) from a fixed
+  // seed. Lives straddle zero so some particles expire on every step.
+  void Seed(std::size_t count, std::uint32_t seed) {
+    Particles::ParticleStreams &s = particles_.particles_;
+    s.Resize(particles_.maxParticles_);
+    std::uint32_t state = seed;
+    auto next = [&state](float lo, float hi) {
+      state = state * 1664525u + 1013904223u;
+      return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+    };
+    for (std::size_t i = 0; i < s.life.size(); ++i) {
+      s.posX[i] = next(-2.0f, 2.0f);
+      s.posY[i] = next(-2.0f, 2.0f);
+      s.posZ[i] = next(-2.0f, 2.0f);
+      s.velX[i] = next(-1.0f, 1.0f);
+      s.velY[i] = next(-1.0f, 1.0f);
+      s.velZ[i] = next(-1.0f, 1.0f);
+      s.colorR[i] = next(0.0f, 1.0f);
+      s.colorG[i] = next(0.0f, 1.0f);
+      s.colorB[i] = next(0.0f, 1.0f);
+      s.colorA[i] = 1.0f;
+      // Unique per slot, so the compaction order can be read back.
+      s.size[i] = static_cast<float>(i);
+      s.life[i] = next(-0.2f, 3.5f);
+    }
+    particles_.liveCount_ = count;
+  }
+
+  void Integrate(float dt) { particles_.Integrate(dt); }
+  void IntegrateScalar(float dt) {
+    particles_.IntegrateScalar(
+        0, Simd::RoundUpToLanes(particles_.liveCount_), dt);
+  }
+  void CompactDead() { particles_.CompactDead(); }
+
+  std::size_t LiveCount() const { return particles_.liveCount_; }
+  std::vector<const std::vector<float> *> Streams() const {
+    const Particles::ParticleStreams &s = particles_.particles_;
+    return {&s.posX,   &s.posY,   &s.posZ,   &s.velX,   &s.velY, &s.velZ,
+            &s.colorR, &s.colorG, &s.colorB, &s.colorA, &s.size, &s.life};
+  }
+  const std::vector<float> &Life() const { return particles_.particles_.life; }
+
+private:
+  Particles &particles_;
+};
+
+namespace {
+
+const char *SimdName() {
+#if defined(SCREENSAVER_SIMD_AVX2)
+  return "AVX2";
+#elif defined(SCREENSAVER_SIMD_SSE2)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+int failures = 0;
+
+void Check(bool condition, const char *what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++failures;
+  }
+}
+
+// Runs the SIMD and the scalar kernel from the same state for a few steps
+// and compares every stream bit for bit, padding included.
+void CheckIntegrate(std::size_t liveCount) {
+  constexpr std::size_t kMaxParticles = 4096;
+  const float steps[] = {1.0f / 30.0f, 1.0f / 144.0f, 0.25f, 1e-4f};
+
+  Particles simd(kMaxParticles);
+  Particles scalar(kMaxParticles);
+  ParticlesTest simdTest(simd);
+  ParticlesTest scalarTest(scalar);
+  simdTest.Seed(liveCount, 1234u);
+  scalarTest.Seed(liveCount, 1234u);
+
+  long mismatches = 0;
+  for (float dt : steps) {
+    simdTest.Integrate(dt);
+    scalarTest.IntegrateScalar(dt);
+    const auto a = simdTest.Streams();
+    const auto b = scalarTest.Streams();
+    for (std::size_t s = 0; s < a.size(); ++s) {
+      if (std::memcmp(a[s]->data(), b[s]->data(),
+                      a[s]->size() * sizeof(float)) != 0) {
+        ++mismatches;
+      }
+    }
+  }
+  std::printf("%s: Integrate over %zu particles, %ld stream mismatches\n",
+              SimdName(), liveCount, mismatches);
+  Check(mismatches == 0, "SIMD Integrate differs from the scalar loop");
+}
+
+// Expires part of the population and checks that CompactDead keeps exactly
+// the survivors, in their original order, with all of their state.
+void CheckCompactDead(std::size_t liveCount) {
+  constexpr std::size_t kMaxParticles = 4096;
+  Particles particles(kMaxParticles);
+  ParticlesTest test(particles);
+  test.Seed(liveCount, 98765u);
+  test.Integrate(0.5f);
+
+  std::vector<std::size_t> survivors;
+  for (std::size_t i = 0; i < liveCount; ++i) {
+    if (test.Life()[i] > 0.0f) {
+      survivors.push_back(i);
+    }
+  }
+  std::vector<std::vector<float>> before;
+  for (const std::vector<float> *stream : test.Streams()) {
+    before.push_back(*stream);
+  }
+
+  test.CompactDead();
+  Check(test.LiveCount() == survivors.size(),
+        "CompactDead kept the wrong number of particles");
+  Check(survivors.size() > 0 && survivors.size() < liveCount,
+        "CompactDead test population did not partly expire");
+
+  const auto after = test.Streams();
+  long moved = 0;
+  for (std::size_t k = 0; k < survivors.size() && k < test.LiveCount(); ++k) {
+    for (std::size_t s = 0; s < after.size(); ++s) {
+      const float expected = before[s][survivors[k]];
+      if (std::memcmp(&(*after[s])[k], &expected, sizeof(float)) != 0) {
+        ++moved;
+      }
+    }
+  }
+  std::printf("CompactDead: %zu of %zu survived, %ld values out of place\n",
+              test.LiveCount(), liveCount, moved);
+  Check(moved == 0, "CompactDead did not keep the survivors in order");
+}
+
+} // namespace
+
+int main() {
+  // Lane width is 4 (SSE2) or 8 (AVX2): 1003 leaves a partial block, and a
+  // single particle is a partial block on its own.
+  CheckIntegrate(1003);
+  CheckIntegrate(1);
+  CheckIntegrate(4096);
+  CheckCompactDead(1003);
+  CheckCompactDead(4096);
+  return failures == 0 ? 0 : 1;
+}